@@ -0,0 +1,311 @@
+#include "ColumnStore.h"
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+
+/* The scans below are written as plain counted loops without branches or early exits,
+ * so that the compiler turns them into SIMD code (-O2 and up). The floating point
+ * reductions need `omp simd` to be reordered, which -fopenmp-simd enables without
+ * pulling in the OpenMP runtime. */
+
+static const uint64_t DEF_ROWS = 64;
+
+typedef struct Column {
+    char* name;
+    CSType type;
+    uint32_t width;
+    char* data;
+} Column;
+
+struct ColumnStore {
+    Column* columns;
+    uint32_t column_count;
+    uint64_t row_count;
+    uint64_t row_capacity;
+};
+
+static uint32_t type_width(CSType type){
+    switch(type){
+    case CS_UINT8: return sizeof(uint8_t);
+    case CS_INT32: return sizeof(int32_t);
+    case CS_INT64: return sizeof(int64_t);
+    case CS_FLOAT: return sizeof(float);
+    case CS_DOUBLE: return sizeof(double);
+    }
+    return 0;
+}
+
+ColumnStore* ColumnStore_new(void){
+    ColumnStore* this = malloc(sizeof(ColumnStore));
+    if(!this)
+        return NULL;
+    this->columns = NULL;
+    this->column_count = 0;
+    this->row_count = 0;
+    this->row_capacity = 0;
+    return this;
+}
+
+void ColumnStore_destroy(ColumnStore* this){
+    for(uint32_t i=0; i<this->column_count; i++){
+        free(this->columns[i].name);
+        free(this->columns[i].data);
+    }
+    free(this->columns);
+    free(this);
+}
+
+void ColumnStore_clear(ColumnStore* this){
+    this->row_count = 0;
+}
+
+/* Returns the index of the new column or -1 */
+int ColumnStore_add_column(ColumnStore* this, const char* name, CSType type){
+    uint32_t width = type_width(type);
+    if(this->row_count != 0 || width == 0)
+        return -1;
+    Column* columns = realloc(this->columns, (this->column_count + 1) * sizeof(Column));
+    if(!columns)
+        return -1;
+    this->columns = columns;
+    Column* column = &columns[this->column_count];
+    column->name = malloc(strlen(name) + 1);
+    column->data = this->row_capacity ? malloc(this->row_capacity * width) : NULL;
+    if(!column->name || (this->row_capacity && !column->data)){
+        free(column->name);
+        free(column->data);
+        return -1;
+    }
+    strcpy(column->name, name);
+    column->type = type;
+    column->width = width;
+    return this->column_count++;
+}
+
+int ColumnStore_find_column(ColumnStore* this, const char* name){
+    for(uint32_t i=0; i<this->column_count; i++)
+        if(strcmp(this->columns[i].name, name) == 0)
+            return i;
+    return -1;
+}
+
+uint32_t ColumnStore_column_count(ColumnStore* this){
+    return this->column_count;
+}
+
+uint64_t ColumnStore_row_count(ColumnStore* this){
+    return this->row_count;
+}
+
+CSType ColumnStore_column_type(ColumnStore* this, uint32_t column){
+    return this->columns[column].type;
+}
+
+const char* ColumnStore_column_name(ColumnStore* this, uint32_t column){
+    if(column >= this->column_count)
+        return NULL;
+    return this->columns[column].name;
+}
+
+void* ColumnStore_column(ColumnStore* this, uint32_t column){
+    if(column >= this->column_count)
+        return NULL;
+    return this->columns[column].data;
+}
+
+int ColumnStore_reserve(ColumnStore* this, uint64_t rows){
+    if(rows <= this->row_capacity)
+        return 0;
+    for(uint32_t i=0; i<this->column_count; i++){
+        char* data = realloc(this->columns[i].data, rows * this->columns[i].width);
+        if(!data)
+            return -1;  /* the columns grown so far keep their bigger arrays, that's harmless */
+        this->columns[i].data = data;
+    }
+    this->row_capacity = rows;
+    return 0;
+}
+
+/* values[i] is the value of column i, interpreted according to the column's type */
+int ColumnStore_append_row(ColumnStore* this, const CSValue* values){
+    if(this->row_count == this->row_capacity)
+        if(ColumnStore_reserve(this, this->row_capacity ? this->row_capacity * 2 : DEF_ROWS) == -1)
+            return -1;
+    uint64_t row = this->row_count;
+    for(uint32_t i=0; i<this->column_count; i++){
+        Column* column = &this->columns[i];
+        memcpy(column->data + row * column->width, &values[i], column->width);
+    }
+    this->row_count++;
+    return 0;
+}
+
+int ColumnStore_get(ColumnStore* this, uint64_t row, uint32_t column, CSValue* value_out){
+    if(row >= this->row_count || column >= this->column_count)
+        return -1;
+    Column* col = &this->columns[column];
+    memcpy(value_out, col->data + row * col->width, col->width);
+    return 0;
+}
+
+#define FILTER_LOOP(T, FIELD, OP) { \
+    const T* data = (const T*)col->data; \
+    const T v = value.FIELD; \
+    for(uint64_t i=0; i<rows; i++) \
+        mask_out[i] = data[i] OP v; \
+    break; \
+}
+
+#define FILTER_TYPE(T, FIELD) { \
+    switch(op){ \
+    case CS_LT: FILTER_LOOP(T, FIELD, <) \
+    case CS_LE: FILTER_LOOP(T, FIELD, <=) \
+    case CS_GT: FILTER_LOOP(T, FIELD, >) \
+    case CS_GE: FILTER_LOOP(T, FIELD, >=) \
+    case CS_EQ: FILTER_LOOP(T, FIELD, ==) \
+    case CS_NE: FILTER_LOOP(T, FIELD, !=) \
+    } \
+    break; \
+}
+
+/* mask_out[row] = column[row] <op> value, for every row. mask_out needs row_count bytes */
+int ColumnStore_filter(ColumnStore* this, uint32_t column, CSCmp op, CSValue value, uint8_t* mask_out){
+    if(column >= this->column_count)
+        return -1;
+    Column* col = &this->columns[column];
+    uint64_t rows = this->row_count;
+    switch(col->type){
+    case CS_UINT8: FILTER_TYPE(uint8_t, u8)
+    case CS_INT32: FILTER_TYPE(int32_t, i32)
+    case CS_INT64: FILTER_TYPE(int64_t, i64)
+    case CS_FLOAT: FILTER_TYPE(float, f32)
+    case CS_DOUBLE: FILTER_TYPE(double, f64)
+    }
+    return 0;
+}
+
+void ColumnStore_mask_and(uint8_t* mask, const uint8_t* other, uint64_t rows){
+    for(uint64_t i=0; i<rows; i++)
+        mask[i] &= other[i];
+}
+
+void ColumnStore_mask_or(uint8_t* mask, const uint8_t* other, uint64_t rows){
+    for(uint64_t i=0; i<rows; i++)
+        mask[i] |= other[i];
+}
+
+uint64_t ColumnStore_mask_count(const uint8_t* mask, uint64_t rows){
+    uint64_t count = 0;
+    for(uint64_t i=0; i<rows; i++)
+        count += mask[i];
+    return count;
+}
+
+/* Writes the indexes of the selected rows to rows_out, which needs room for `rows` entries.
+ * Returns how many were selected. */
+uint64_t ColumnStore_mask_to_rows(const uint8_t* mask, uint64_t rows, uint64_t* rows_out){
+    uint64_t count = 0;
+    for(uint64_t i=0; i<rows; i++){
+        rows_out[count] = i;
+        count += mask[i];
+    }
+    return count;
+}
+
+/* The reductions are tagged for the vectorizer. Without OpenMP (or -fopenmp-simd, which
+ * defines no macro of its own, hence CS_OPENMP_SIMD in the Makefile) the tags expand to nothing
+ * instead of tripping -Wunknown-pragmas. */
+#if defined(_OPENMP) || defined(CS_OPENMP_SIMD)
+#define SIMD_PRAGMA(x) _Pragma(x)
+#else
+#define SIMD_PRAGMA(x)
+#endif
+
+#define SUM_LOOP(T, ACC_T) { \
+    const T* data = (const T*)col->data; \
+    ACC_T sum = 0; \
+    if(mask){ \
+        SIMD_PRAGMA("omp simd reduction(+:sum)") \
+        for(uint64_t i=0; i<rows; i++) \
+            sum += mask[i] ? (ACC_T)data[i] : 0; \
+    } \
+    else { \
+        SIMD_PRAGMA("omp simd reduction(+:sum)") \
+        for(uint64_t i=0; i<rows; i++) \
+            sum += data[i]; \
+    } \
+    return (double)sum; \
+}
+
+double ColumnStore_sum(ColumnStore* this, uint32_t column, const uint8_t* mask){
+    if(column >= this->column_count)
+        return 0;
+    Column* col = &this->columns[column];
+    uint64_t rows = this->row_count;
+    switch(col->type){
+    case CS_UINT8: SUM_LOOP(uint8_t, uint64_t)
+    case CS_INT32: SUM_LOOP(int32_t, int64_t)
+    case CS_INT64: SUM_LOOP(int64_t, int64_t)
+    case CS_FLOAT: SUM_LOOP(float, double)
+    case CS_DOUBLE: SUM_LOOP(double, double)
+    }
+    return 0;
+}
+
+#define EXTREME_LOOP(T, FIELD, START, OP, RED) { \
+    const T* data = (const T*)col->data; \
+    T result = START; \
+    if(mask){ \
+        SIMD_PRAGMA(RED) \
+        for(uint64_t i=0; i<rows; i++) \
+            result = (mask[i] && data[i] OP result) ? data[i] : result; \
+    } \
+    else { \
+        SIMD_PRAGMA(RED) \
+        for(uint64_t i=0; i<rows; i++) \
+            result = data[i] OP result ? data[i] : result; \
+    } \
+    value_out->FIELD = result; \
+    return 0; \
+}
+
+#define MIN_RED "omp simd reduction(min:result)"
+#define MAX_RED "omp simd reduction(max:result)"
+
+static bool has_selected_rows(ColumnStore* this, const uint8_t* mask){
+    if(mask)
+        return ColumnStore_mask_count(mask, this->row_count) > 0;
+    return this->row_count > 0;
+}
+
+/* Returns -1 if no row is selected */
+int ColumnStore_min(ColumnStore* this, uint32_t column, const uint8_t* mask, CSValue* value_out){
+    if(column >= this->column_count || !has_selected_rows(this, mask))
+        return -1;
+    Column* col = &this->columns[column];
+    uint64_t rows = this->row_count;
+    switch(col->type){
+    case CS_UINT8: EXTREME_LOOP(uint8_t, u8, UINT8_MAX, <, MIN_RED)
+    case CS_INT32: EXTREME_LOOP(int32_t, i32, INT32_MAX, <, MIN_RED)
+    case CS_INT64: EXTREME_LOOP(int64_t, i64, INT64_MAX, <, MIN_RED)
+    case CS_FLOAT: EXTREME_LOOP(float, f32, FLT_MAX, <, MIN_RED)
+    case CS_DOUBLE: EXTREME_LOOP(double, f64, DBL_MAX, <, MIN_RED)
+    }
+    return -1;
+}
+
+/* Returns -1 if no row is selected */
+int ColumnStore_max(ColumnStore* this, uint32_t column, const uint8_t* mask, CSValue* value_out){
+    if(column >= this->column_count || !has_selected_rows(this, mask))
+        return -1;
+    Column* col = &this->columns[column];
+    uint64_t rows = this->row_count;
+    switch(col->type){
+    case CS_UINT8: EXTREME_LOOP(uint8_t, u8, 0, >, MAX_RED)
+    case CS_INT32: EXTREME_LOOP(int32_t, i32, INT32_MIN, >, MAX_RED)
+    case CS_INT64: EXTREME_LOOP(int64_t, i64, INT64_MIN, >, MAX_RED)
+    case CS_FLOAT: EXTREME_LOOP(float, f32, -FLT_MAX, >, MAX_RED)
+    case CS_DOUBLE: EXTREME_LOOP(double, f64, -DBL_MAX, >, MAX_RED)
+    }
+    return -1;
+}
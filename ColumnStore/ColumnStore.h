@@ -0,0 +1,49 @@
+#ifndef _MY_COLUMN_STORE_
+#define _MY_COLUMN_STORE_
+#include <inttypes.h>
+#include <stdbool.h>
+
+/* Opaque types */
+typedef struct ColumnStore ColumnStore;
+
+/* Types */
+typedef enum CSType { CS_UINT8, CS_INT32, CS_INT64, CS_FLOAT, CS_DOUBLE } CSType;
+typedef enum CSCmp { CS_LT, CS_LE, CS_GT, CS_GE, CS_EQ, CS_NE } CSCmp;
+
+typedef union CSValue {
+    uint8_t u8;
+    int32_t i32;
+    int64_t i64;
+    float f32;
+    double f64;
+} CSValue;
+
+/* ColumnStore methods
+ * Records are stored struct-of-arrays: one contiguous array per column.
+ * Columns are added while the store is empty; ColumnStore_column(...) returns the raw array
+ * (uint8_t*, int32_t*, int64_t*, float* or double*), valid until the next append/reserve. */
+ColumnStore* ColumnStore_new(void);
+void ColumnStore_destroy(ColumnStore* this);
+void ColumnStore_clear(ColumnStore* this);
+int ColumnStore_add_column(ColumnStore* this, const char* name, CSType type);
+int ColumnStore_find_column(ColumnStore* this, const char* name);
+uint32_t ColumnStore_column_count(ColumnStore* this);
+uint64_t ColumnStore_row_count(ColumnStore* this);
+CSType ColumnStore_column_type(ColumnStore* this, uint32_t column);
+const char* ColumnStore_column_name(ColumnStore* this, uint32_t column);
+void* ColumnStore_column(ColumnStore* this, uint32_t column);
+int ColumnStore_reserve(ColumnStore* this, uint64_t rows);
+int ColumnStore_append_row(ColumnStore* this, const CSValue* values);
+int ColumnStore_get(ColumnStore* this, uint64_t row, uint32_t column, CSValue* value_out);
+
+/* Column scans. Masks hold one byte (0 or 1) per row; a NULL mask selects every row */
+int ColumnStore_filter(ColumnStore* this, uint32_t column, CSCmp op, CSValue value, uint8_t* mask_out);
+void ColumnStore_mask_and(uint8_t* mask, const uint8_t* other, uint64_t rows);
+void ColumnStore_mask_or(uint8_t* mask, const uint8_t* other, uint64_t rows);
+uint64_t ColumnStore_mask_count(const uint8_t* mask, uint64_t rows);
+uint64_t ColumnStore_mask_to_rows(const uint8_t* mask, uint64_t rows, uint64_t* rows_out);
+double ColumnStore_sum(ColumnStore* this, uint32_t column, const uint8_t* mask);
+int ColumnStore_min(ColumnStore* this, uint32_t column, const uint8_t* mask, CSValue* value_out);
+int ColumnStore_max(ColumnStore* this, uint32_t column, const uint8_t* mask, CSValue* value_out);
+
+#endif
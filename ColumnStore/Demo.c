@@ -0,0 +1,45 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "ColumnStore.h"
+
+int main(int argc, const char* argv[]) {
+    ColumnStore* trades = ColumnStore_new();
+    int id = ColumnStore_add_column(trades, "id", CS_INT64);
+    int price = ColumnStore_add_column(trades, "price", CS_DOUBLE);
+    int quantity = ColumnStore_add_column(trades, "quantity", CS_INT32);
+    int side = ColumnStore_add_column(trades, "side", CS_UINT8);
+
+    const uint64_t rows = 1000000;
+    ColumnStore_reserve(trades, rows);
+    for (uint64_t i = 0; i < rows; i++) {
+        CSValue row[4];
+        row[id].i64 = i;
+        row[price].f64 = 50.0 + (i % 1000) * 0.1;
+        row[quantity].i32 = 1 + i % 50;
+        row[side].u8 = i % 2;
+        ColumnStore_append_row(trades, row);
+    }
+
+    // select price > 120 and side == buy, touching only those two columns
+    uint8_t* mask = malloc(rows);
+    uint8_t* buys = malloc(rows);
+    ColumnStore_filter(trades, price, CS_GT, (CSValue) { .f64 = 120.0 }, mask);
+    ColumnStore_filter(trades, side, CS_EQ, (CSValue) { .u8 = 1 }, buys);
+    ColumnStore_mask_and(mask, buys, rows);
+
+    CSValue min_price, max_quantity;
+    ColumnStore_min(trades, price, mask, &min_price);
+    ColumnStore_max(trades, quantity, mask, &max_quantity);
+    printf("matching rows: %lu\n", ColumnStore_mask_count(mask, rows));
+    printf("total quantity: %.0f\n", ColumnStore_sum(trades, quantity, mask));
+    printf("min price: %.2f, max quantity: %d\n", min_price.f64, max_quantity.i32);
+
+    // plain column access for custom loops
+    const double* prices = ColumnStore_column(trades, price);
+    printf("average price (all rows): %.3f (first: %.2f)\n", ColumnStore_sum(trades, price, NULL) / rows, prices[0]);
+
+    free(mask);
+    free(buys);
+    ColumnStore_destroy(trades);
+    return 0;
+}
@@ -0,0 +1,58 @@
+#include "Epoch.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define READERS 3
+#define UPDATES 100000
+
+typedef struct Config {
+    int version;
+    int values[16];
+} Config;
+
+static _Atomic(Config*) current;
+static atomic_bool done;
+
+// readers keep using whatever config is current, the writer replaces it under their feet
+void* reader(void* arg) {
+    long checks = 0;
+    while (!atomic_load(&done)) {
+        Epoch_enter();
+        Config* config = atomic_load(&current);
+        for (int i = 0; i < 16; i++)
+            if (config->values[i] != config->version)
+                printf("torn config!\n");
+        Epoch_exit();
+        checks++;
+    }
+    printf("reader checked %ld configs\n", checks);
+    return NULL;
+}
+
+int main(int argc, const char* argv[]) {
+    Config* first = calloc(1, sizeof(Config));
+    atomic_store(&current, first);
+    pthread_t threads[READERS];
+    for (int i = 0; i < READERS; i++)
+        pthread_create(&threads[i], NULL, reader, NULL);
+
+    for (int version = 1; version <= UPDATES; version++) {
+        Config* config = malloc(sizeof(Config));
+        config->version = version;
+        for (int i = 0; i < 16; i++)
+            config->values[i] = version;
+        Config* old = atomic_exchange(&current, config);
+        Epoch_retire(old, free);   // freed once no reader can still be looking at it
+    }
+    atomic_store(&done, true);
+    for (int i = 0; i < READERS; i++)
+        pthread_join(threads[i], NULL);
+
+    Epoch_barrier();
+    free(atomic_load(&current));
+    printf("published %d configs\n", UPDATES);
+    return 0;
+}
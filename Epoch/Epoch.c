@@ -0,0 +1,169 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <sched.h>
+#include "Epoch.h"
+
+/* There is one global epoch. A thread inside a section publishes the epoch it saw on entry,
+ * and the global epoch only moves from e to e + 1 once every thread inside a section has seen e.
+ * Memory retired while the global epoch was e is unreachable for sections entered after that,
+ * so it is safe to free when the global epoch reaches e + 2. */
+
+static const uint32_t COLLECT_EVERY = 64;
+
+typedef struct Retired {
+    void* ptr;
+    void (*free_fn)(void* );
+    uint64_t epoch;
+} Retired;
+
+/* One per registered thread, on its own cache line since other threads scan the state */
+typedef struct EpochRecord {
+    _Alignas(64) atomic_uint_fast64_t state;    /* (epoch << 1) | 1 inside a section, 0 outside */
+    atomic_bool in_use;
+    uint32_t nesting;
+    Retired* retired;
+    uint32_t retired_count;
+    uint32_t retired_capacity;
+} EpochRecord;
+
+static EpochRecord records[EPOCH_MAX_THREADS];
+static atomic_uint records_used;        /* records past this index were never claimed */
+static atomic_uint_fast64_t global_epoch;
+
+static pthread_key_t record_key;
+static pthread_once_t record_key_once = PTHREAD_ONCE_INIT;
+static _Thread_local EpochRecord* local_record;
+
+static void collect(EpochRecord* record){
+    uint64_t epoch = atomic_load(&global_epoch);
+    uint32_t kept = 0;
+    for(uint32_t i=0; i<record->retired_count; i++){
+        Retired item = record->retired[i];
+        if(item.epoch + 2 <= epoch)
+            item.free_fn(item.ptr);
+        else
+            record->retired[kept++] = item;
+    }
+    record->retired_count = kept;
+}
+
+/* Returns true if the global epoch moved on (by this thread or another one) */
+static bool try_advance(void){
+    uint64_t epoch = atomic_load(&global_epoch);
+    uint32_t used = atomic_load(&records_used);
+    for(uint32_t i=0; i<used; i++){
+        uint64_t state = atomic_load(&records[i].state);
+        if((state & 1) && (state >> 1) != epoch)
+            return false;
+    }
+    atomic_compare_exchange_strong(&global_epoch, &epoch, epoch + 1);
+    return true;
+}
+
+/* Called on thread exit. What is still pending stays in the record, for the next thread
+ * that claims it or for Epoch_barrier. */
+static void release_record(void* arg){
+    EpochRecord* record = arg;
+    try_advance();
+    collect(record);
+    record->nesting = 0;
+    atomic_store(&record->state, 0);
+    atomic_store(&record->in_use, false);
+}
+
+static void create_record_key(void){
+    pthread_key_create(&record_key, release_record);
+}
+
+static bool claim_record(EpochRecord* record){
+    bool expected = false;
+    return atomic_compare_exchange_strong(&record->in_use, &expected, true);
+}
+
+static EpochRecord* get_record(void){
+    if(local_record)
+        return local_record;
+    pthread_once(&record_key_once, create_record_key);
+    EpochRecord* record = NULL;
+    while(record == NULL){
+        for(uint32_t i=0; i<EPOCH_MAX_THREADS && record == NULL; i++)
+            if(claim_record(&records[i]))
+                record = &records[i];
+        if(record == NULL)
+            sched_yield();  /* every slot is taken, wait for a thread to exit */
+    }
+    uint32_t index = record - records;
+    uint32_t used = atomic_load(&records_used);
+    while(used <= index && !atomic_compare_exchange_weak(&records_used, &used, index + 1))
+        ;
+    pthread_setspecific(record_key, record);
+    local_record = record;
+    return record;
+}
+
+void Epoch_enter(void){
+    EpochRecord* record = get_record();
+    if(record->nesting++ == 0){
+        atomic_store_explicit(&record->state, (atomic_load(&global_epoch) << 1) | 1, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+    }
+}
+
+void Epoch_exit(void){
+    EpochRecord* record = local_record;
+    if(--record->nesting == 0)
+        atomic_store_explicit(&record->state, 0, memory_order_release);
+}
+
+/* Waits until no section that was open at the time of the call is still open */
+static void wait_for_readers(void){
+    uint64_t target = atomic_load(&global_epoch) + 2;
+    while(atomic_load(&global_epoch) < target)
+        if(!try_advance())
+            sched_yield();
+}
+
+void Epoch_retire(void* ptr, void (*free_fn)(void* )){
+    EpochRecord* record = get_record();
+    if(record->retired_count == record->retired_capacity){
+        uint32_t capacity = record->retired_capacity ? record->retired_capacity * 2 : COLLECT_EVERY;
+        Retired* retired = realloc(record->retired, capacity * sizeof(Retired));
+        if(!retired){
+            /* nowhere to park it: free it right away when that can be made safe, or leak it */
+            if(record->nesting == 0){
+                wait_for_readers();
+                free_fn(ptr);
+            }
+            return;
+        }
+        record->retired = retired;
+        record->retired_capacity = capacity;
+    }
+    record->retired[record->retired_count++] = (Retired) {
+        .ptr = ptr,
+        .free_fn = free_fn,
+        .epoch = atomic_load(&global_epoch)
+    };
+    if(record->retired_count % COLLECT_EVERY == 0){
+        try_advance();
+        collect(record);
+    }
+}
+
+/* Frees everything retired so far by this thread and by threads that have exited.
+ * Waits for the sections open in other threads to end, so it must not be called inside one. */
+void Epoch_barrier(void){
+    EpochRecord* own = get_record();
+    wait_for_readers();
+    collect(own);
+    uint32_t used = atomic_load(&records_used);
+    for(uint32_t i=0; i<used; i++){
+        if(claim_record(&records[i])){
+            collect(&records[i]);
+            atomic_store(&records[i].in_use, false);
+        }
+    }
+}
@@ -0,0 +1,17 @@
+#ifndef _MY_EPOCH_
+#define _MY_EPOCH_
+
+/* Epoch based memory reclamation, shared by the lock-free containers.
+ * Readers wrap their accesses to shared nodes in Epoch_enter / Epoch_exit (the sections nest).
+ * A writer that unlinks a node hands it to Epoch_retire instead of freeing it, and it is freed
+ * once every thread that was inside a section at that time has left it.
+ * Up to EPOCH_MAX_THREADS threads can be registered at once, a thread registers on its first
+ * call and its slot is released when it exits. */
+#define EPOCH_MAX_THREADS 256
+
+void Epoch_enter(void);
+void Epoch_exit(void);
+void Epoch_retire(void* ptr, void (*free_fn)(void* ));
+void Epoch_barrier(void);
+
+#endif
@@ -0,0 +1,40 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "FlatMap.h"
+
+const char* WORDS[] = { "pear", "apple", "fig", "kiwi", "banana", "cherry", "date", "apple", "grape", "lime" };
+const uint64_t WORDS_SIZE = sizeof(WORDS) / sizeof(WORDS[0]);
+
+int main(int argc, const char* argv[]) {
+    FlatMap* fruits = FlatMap_new_str();
+    uint64_t* ranks = malloc(WORDS_SIZE * sizeof(uint64_t));
+    void* values[WORDS_SIZE];
+    for (uint64_t i = 0; i < WORDS_SIZE; i++) {
+        ranks[i] = i;
+        values[i] = &ranks[i];
+    }
+
+    // bulk build from unsorted input, the second "apple" wins
+    FlatMap_build(fruits, (void* const*)WORDS, values, WORDS_SIZE);
+    FMPair* pair;
+    FMPair_for(fruits, pair)
+        printf("%s: %lu\n", (const char*)pair->key, *(uint64_t*)pair->value);
+
+    puts("-- range [c, h) ------");
+    FMRange_for(fruits, "c", "h", pair)
+        printf("%s\n", (const char*)pair->key);
+
+    // integer keys, searched through the Eytzinger layout
+    FlatMap* squares = FlatMap_new_int();
+    for (uintptr_t i = 1000; i > 0; i--)
+        FlatMap_insert(squares, (void*)(i * i), NULL);
+    FlatMap_build_eytzinger(squares);
+    uint64_t idx = FlatMap_lower_bound(squares, (void*)500000);
+    printf("-- first square >= 500000: %lu (index %lu)\n", (uintptr_t)FlatMap_key_at(squares, idx), idx);
+    printf("contains 4096: %d, contains 4097: %d\n", FlatMap_contains(squares, (void*)4096), FlatMap_contains(squares, (void*)4097));
+
+    FlatMap_destroy(squares);
+    FlatMap_destroy(fruits);
+    free(ranks);
+    return 0;
+}
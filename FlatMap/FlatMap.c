@@ -0,0 +1,323 @@
+#include "FlatMap.h"
+#include "../Vector/Vector.h"
+#include <stdlib.h>
+#include <string.h>
+
+typedef int (*cmp_fn)(const void* , const void* );
+
+struct FlatMap {
+    Vector* keys;               /* sorted */
+    Vector* values;             /* values[i] belongs to keys[i] */
+    cmp_fn cmp;                 /* NULL: keys are integers */
+    const void** eytz_keys;     /* keys in BFS order of the implicit search tree, 1-indexed */
+    uint64_t* eytz_index;       /* eytz_keys[k] == keys[eytz_index[k]] */
+};
+
+typedef struct FMEntry {
+    const void* key;
+    void* value;
+    uint64_t order;
+} FMEntry;
+
+static inline bool key_less(cmp_fn cmp, const void* a, const void* b){
+    if(cmp == NULL)
+        return (uintptr_t)a < (uintptr_t)b;
+    return cmp(a, b) < 0;
+}
+
+static int str_cmp(const void* a, const void* b){
+    return strcmp(a, b);
+}
+
+FlatMap* FlatMap_new(int (*cmp)(const void* key_a, const void* key_b)){
+    FlatMap* this = malloc(sizeof(FlatMap));
+    if(!this)
+        return NULL;
+    this->keys = Vector_new();
+    this->values = Vector_new();
+    if(!this->keys || !this->values){
+        if(this->keys)
+            Vector_destroy(this->keys);
+        if(this->values)
+            Vector_destroy(this->values);
+        free(this);
+        return NULL;
+    }
+    this->cmp = cmp;
+    this->eytz_keys = NULL;
+    this->eytz_index = NULL;
+    return this;
+}
+
+FlatMap* FlatMap_new_str(void){
+    return FlatMap_new(str_cmp);
+}
+
+FlatMap* FlatMap_new_int(void){
+    return FlatMap_new(NULL);
+}
+
+static void FlatMap_drop_eytzinger(FlatMap* this){
+    free(this->eytz_keys);
+    free(this->eytz_index);
+    this->eytz_keys = NULL;
+    this->eytz_index = NULL;
+}
+
+void FlatMap_destroy(FlatMap* this){
+    FlatMap_drop_eytzinger(this);
+    Vector_destroy(this->keys);
+    Vector_destroy(this->values);
+    free(this);
+}
+
+void FlatMap_clear(FlatMap* this){
+    FlatMap_drop_eytzinger(this);
+    Vector_clear(this->keys);
+    Vector_clear(this->values);
+}
+
+uint64_t FlatMap_size(FlatMap* this){
+    return Vector_size(this->keys);
+}
+
+/* Vector_sort comparators take no context, the key comparator is passed on the side */
+static _Thread_local cmp_fn build_cmp;
+
+static int entry_cmp(const void* a, const void* b){
+    const FMEntry* x = a;
+    const FMEntry* y = b;
+    if(key_less(build_cmp, x->key, y->key))
+        return -1;
+    if(key_less(build_cmp, y->key, x->key))
+        return 1;
+    return (x->order > y->order) - (x->order < y->order);
+}
+
+/* Replaces the contents with count pairs in any order. For equal keys the last pair wins.
+ * values may be NULL to build a set. */
+int FlatMap_build(FlatMap* this, void* const* keys, void* const* values, uint64_t count){
+    if(count == 0){
+        FlatMap_clear(this);
+        return 0;
+    }
+    FMEntry* entries = malloc(count * sizeof(FMEntry));
+    Vector* order = Vector_new_init_size(count);
+    void** sorted = malloc(2 * count * sizeof(void*));
+    if(!entries || !order || !sorted || Vector_reserve(this->keys, count) == -1 || Vector_reserve(this->values, count) == -1){
+        free(entries);
+        free(sorted);
+        if(order)
+            Vector_destroy(order);
+        return -1;
+    }
+    for(uint64_t i=0; i<count; i++){
+        entries[i] = (FMEntry) { .key = keys[i], .value = values ? values[i] : NULL, .order = i };
+        Vector_pushback(order, &entries[i]);
+    }
+    build_cmp = this->cmp;
+    Vector_sort(order, entry_cmp);
+
+    void** sorted_keys = sorted;
+    void** sorted_values = sorted + count;
+    void** table = Vector_data(order);
+    uint64_t unique = 0;
+    for(uint64_t i=0; i<count; i++){
+        FMEntry* entry = table[i];
+        if(unique > 0 && !key_less(this->cmp, sorted_keys[unique - 1], entry->key))
+            unique--;   /* same key as the previous entry, which came earlier in the input */
+        sorted_keys[unique] = (void*)entry->key;
+        sorted_values[unique] = entry->value;
+        unique++;
+    }
+    FlatMap_clear(this);
+    Vector_append_array(this->keys, sorted_keys, unique);
+    Vector_append_array(this->values, sorted_values, unique);
+
+    Vector_destroy(order);
+    free(entries);
+    free(sorted);
+    return 0;
+}
+
+/* Branchless binary search over the sorted keys */
+static uint64_t sorted_lower_bound(FlatMap* this, const void* key){
+    uint64_t len = Vector_size(this->keys);
+    if(len == 0)
+        return 0;
+    void** keys = Vector_data(this->keys);
+    void** base = keys;
+    cmp_fn cmp = this->cmp;
+    if(cmp == NULL){
+        while(len > 1){
+            uint64_t half = len / 2;
+            base = ((uintptr_t)base[half] < (uintptr_t)key) ? base + half : base;
+            len -= half;
+        }
+        return (base - keys) + ((uintptr_t)*base < (uintptr_t)key);
+    }
+    while(len > 1){
+        uint64_t half = len / 2;
+        base = (cmp(base[half], key) < 0) ? base + half : base;
+        len -= half;
+    }
+    return (base - keys) + (cmp(*base, key) < 0);
+}
+
+/* Search in the Eytzinger layout: the path down the implicit tree is the bits of k,
+ * the children of k are 2k and 2k+1 so the next levels can be prefetched ahead.
+ * Once k falls off the tree, the lower bound is the last node we went left at. */
+static uint64_t eytzinger_lower_bound(FlatMap* this, const void* key){
+    uint64_t n = Vector_size(this->keys);
+    const void** eytz = this->eytz_keys;
+    cmp_fn cmp = this->cmp;
+    uint64_t k = 1;
+    if(cmp == NULL){
+        while(k <= n){
+            __builtin_prefetch(eytz + 16 * k);
+            k = 2 * k + ((uintptr_t)eytz[k] < (uintptr_t)key);
+        }
+    }
+    else {
+        while(k <= n){
+            __builtin_prefetch(eytz + 16 * k);
+            k = 2 * k + (cmp(eytz[k], key) < 0);
+        }
+    }
+    k >>= __builtin_ffsll(~k);
+    return k == 0 ? n : this->eytz_index[k];
+}
+
+static uint64_t eytzinger_fill(FlatMap* this, void** keys, uint64_t n, uint64_t i, uint64_t k){
+    if(k <= n){
+        i = eytzinger_fill(this, keys, n, i, 2 * k);
+        this->eytz_keys[k] = keys[i];
+        this->eytz_index[k] = i++;
+        i = eytzinger_fill(this, keys, n, i, 2 * k + 1);
+    }
+    return i;
+}
+
+/* Builds the read optimized search index. Any insert or remove drops it. */
+int FlatMap_build_eytzinger(FlatMap* this){
+    FlatMap_drop_eytzinger(this);
+    uint64_t n = Vector_size(this->keys);
+    this->eytz_keys = malloc((n + 1) * sizeof(void*));
+    this->eytz_index = malloc((n + 1) * sizeof(uint64_t));
+    if(!this->eytz_keys || !this->eytz_index){
+        FlatMap_drop_eytzinger(this);
+        return -1;
+    }
+    eytzinger_fill(this, Vector_data(this->keys), n, 0, 1);
+    return 0;
+}
+
+bool FlatMap_has_eytzinger(FlatMap* this){
+    return this->eytz_keys != NULL;
+}
+
+uint64_t FlatMap_lower_bound(FlatMap* this, const void* key){
+    if(this->eytz_keys)
+        return eytzinger_lower_bound(this, key);
+    return sorted_lower_bound(this, key);
+}
+
+uint64_t FlatMap_upper_bound(FlatMap* this, const void* key){
+    uint64_t idx = FlatMap_lower_bound(this, key);
+    uint64_t size = Vector_size(this->keys);
+    void** keys = Vector_data(this->keys);
+    if(idx < size && !key_less(this->cmp, key, keys[idx]))
+        idx++;
+    return idx;
+}
+
+/* Returns the index of key or -1 */
+static int64_t FlatMap_find(FlatMap* this, const void* key){
+    uint64_t idx = FlatMap_lower_bound(this, key);
+    if(idx == Vector_size(this->keys) || key_less(this->cmp, key, Vector_data(this->keys)[idx]))
+        return -1;
+    return idx;
+}
+
+bool FlatMap_contains(FlatMap* this, const void* key){
+    return FlatMap_find(this, key) != -1;
+}
+
+void* FlatMap_get(FlatMap* this, const void* key){
+    int64_t idx = FlatMap_find(this, key);
+    if(idx == -1)
+        return NULL;
+    return Vector_data(this->values)[idx];
+}
+
+int FlatMap_insert(FlatMap* this, const void* key, const void* value){
+    uint64_t idx = sorted_lower_bound(this, key);
+    if(idx < Vector_size(this->keys) && !key_less(this->cmp, key, Vector_data(this->keys)[idx])){
+        Vector_data(this->values)[idx] = (void*)value;
+        return 0;
+    }
+    FlatMap_drop_eytzinger(this);
+    if(Vector_insert_range(this->keys, idx, (void* const*)&key, 1) == -1)
+        return -1;
+    if(Vector_insert_range(this->values, idx, (void* const*)&value, 1) == -1){
+        Vector_erase_range(this->keys, idx, 1);
+        return -1;
+    }
+    return 0;
+}
+
+void* FlatMap_remove(FlatMap* this, const void* key){
+    int64_t idx = FlatMap_find(this, key);
+    if(idx == -1)
+        return NULL;
+    void* value = Vector_data(this->values)[idx];
+    FlatMap_drop_eytzinger(this);
+    Vector_erase_range(this->keys, idx, 1);
+    Vector_erase_range(this->values, idx, 1);
+    return value;
+}
+
+const void* FlatMap_key_at(FlatMap* this, uint64_t index){
+    if(index >= Vector_size(this->keys))
+        return NULL;
+    return Vector_data(this->keys)[index];
+}
+
+void* FlatMap_value_at(FlatMap* this, uint64_t index){
+    if(index >= Vector_size(this->values))
+        return NULL;
+    return Vector_data(this->values)[index];
+}
+
+FMIterator FMIterator_new(FlatMap* map){
+    return (FMIterator) {
+        .map = map,
+        .index = 0,
+        .end = Vector_size(map->keys)
+    };
+}
+
+FMIterator FMIterator_new_range(FlatMap* map, const void* lo_key, const void* hi_key){
+    uint64_t begin = FlatMap_lower_bound(map, lo_key);
+    uint64_t end = FlatMap_lower_bound(map, hi_key);
+    return (FMIterator) {
+        .map = map,
+        .index = begin,
+        .end = end > begin ? end : begin
+    };
+}
+
+FMPair* FMIterator_peak(FMIterator* this){
+    if(this->index >= this->end)
+        return NULL;
+    this->pair.key = Vector_data(this->map->keys)[this->index];
+    this->pair.value = Vector_data(this->map->values)[this->index];
+    return &(this->pair);
+}
+
+FMPair* FMIterator_next(FMIterator* this){
+    FMPair* pair = FMIterator_peak(this);
+    if(pair)
+        this->index++;
+    return pair;
+}
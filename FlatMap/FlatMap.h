@@ -0,0 +1,60 @@
+#ifndef _MY_FLAT_MAP_
+#define _MY_FLAT_MAP_
+#include <inttypes.h>
+#include <stdbool.h>
+
+#define _MERGE_(prefix, num) prefix##num
+#define _LABEL_(num) _MERGE_(_uniq_, num)
+#define _UNIQUE_ID_ _LABEL_(__COUNTER__)
+
+/* Opaque types */
+typedef struct FlatMap FlatMap;
+
+/* Types */
+typedef struct FMPair {
+    const void* key;
+    void* value;
+} FMPair;
+
+typedef struct FMIterator {
+    FlatMap* map;
+    uint64_t index;
+    uint64_t end;
+    FMPair pair;
+} FMIterator;
+
+/* FlatMap methods
+ * Keys are kept sorted in a Vector, values in a parallel Vector. Keys and values are not owned.
+ * FlatMap_new_int() maps integer keys (cast to pointers) and compares them without a callback.
+ * A set is a FlatMap whose values are unused (NULL is allowed). */
+FlatMap* FlatMap_new(int (*cmp)(const void* key_a, const void* key_b));
+FlatMap* FlatMap_new_str(void);
+FlatMap* FlatMap_new_int(void);
+void FlatMap_destroy(FlatMap* this);
+void FlatMap_clear(FlatMap* this);
+uint64_t FlatMap_size(FlatMap* this);
+int FlatMap_build(FlatMap* this, void* const* keys, void* const* values, uint64_t count);
+int FlatMap_insert(FlatMap* this, const void* key, const void* value);
+void* FlatMap_remove(FlatMap* this, const void* key);
+bool FlatMap_contains(FlatMap* this, const void* key);
+void* FlatMap_get(FlatMap* this, const void* key);
+uint64_t FlatMap_lower_bound(FlatMap* this, const void* key);
+uint64_t FlatMap_upper_bound(FlatMap* this, const void* key);
+const void* FlatMap_key_at(FlatMap* this, uint64_t index);
+void* FlatMap_value_at(FlatMap* this, uint64_t index);
+int FlatMap_build_eytzinger(FlatMap* this);
+bool FlatMap_has_eytzinger(FlatMap* this);
+
+/* FMIterator methods + macro. Ranges are [lo_key, hi_key) */
+FMIterator FMIterator_new(FlatMap* map);
+FMIterator FMIterator_new_range(FlatMap* map, const void* lo_key, const void* hi_key);
+FMPair* FMIterator_peak(FMIterator* this);
+FMPair* FMIterator_next(FMIterator* this);
+
+#define _FMPair_for_(_it, _map, _pair) for (FMIterator _it = FMIterator_new(_map); (_pair = FMIterator_next(&_it)) != NULL; )
+#define FMPair_for(map, pair) _FMPair_for_(_UNIQUE_ID_, map, pair)
+#define _FMRange_for_(_it, _map, _lo, _hi, _pair) for (FMIterator _it = FMIterator_new_range(_map, _lo, _hi); (_pair = FMIterator_next(&_it)) != NULL; )
+#define FMRange_for(map, lo, hi, pair) _FMRange_for_(_UNIQUE_ID_, map, lo, hi, pair)
+
+
+#endif
@@ -1,4 +1,5 @@
 #include "HashTable.h"
+#include "../String/String.h"
 #include <stdio.h>
 
 void map_func_triple(void* ht_elem){
@@ -48,6 +49,19 @@ int main(int argc, const char** argv){
     HTPair_for(ht, key, data_i)
         printf("%s - %d\n", key, *data_i);
 
+    // =============================================
+
+    printf("======= String keys ========\n");
+    int f = 7;
+    String* str_key = String_new_copy("c");
+    printf("c - %d\n", *(int*)HashTable_get_str(ht, str_key));
+    String_append_char(str_key, 'c');
+    HashTable_insert_str(ht, str_key, &f);
+    printf("cc - %d\n", *(int*)HashTable_get_str(ht, str_key));
+    HashTable_remove_str(ht, str_key);
+    printf("contains cc: %d\n", HashTable_contains_str(ht, str_key));
+    String_destroy(str_key);
+
 
     HashTable_destroy(ht);
     return 0;
@@ -1,4 +1,7 @@
 #include "HashTable.h"
+#include "../Intern/Intern.h"
+#include "../String/String.h"
+#include "../String/StringHash.h"
 #include <string.h>
 #include <stdlib.h>
 
@@ -7,8 +10,10 @@ typedef struct Node Node;
 const uint32_t DEF_SIZE = 509;
 const double DEF_MAX_LOAD_FACTOR = 0.7;
 
+/* Keys are interned (../Intern), so a key shared by many tables is stored once and the
+ * _interned methods find it by its precomputed hash and a pointer compare. */
 struct Node {
-    char* key;
+    const InternStr* key;
     void* data;
     int32_t deleted;
 };
@@ -23,24 +28,27 @@ struct HashTable {
 };
 
 static uint32_t def_hash_function(const char* key, uint32_t table_size){
-    static const uint32_t HASH_MUTLIPLIER = 65599;
-    uint32_t hash_value = 0;
-    while(*key)
-        hash_value = hash_value * HASH_MUTLIPLIER + *key++;
-    return hash_value % table_size;
+    return string_hash_c_str(key) % table_size;
 }
 
-static Node* Node_new(const char* key, const void* data){
+static Node* Node_new(const InternStr* key, const void* data){
     Node* this = malloc(sizeof(Node));
-    this->key = malloc(sizeof(char) * (strlen(key) + 1));
-    strcpy(this->key, key);
+    if(!this)
+        return NULL;
+    this->key = Intern_retain(key);
     this->data = (void*)data;
     this->deleted = 0;
     return this;
 }
 
+static inline uint32_t HashTable_index(HashTable* this, const InternStr* key){
+    if(this->hash_function == def_hash_function)
+        return key->hash % this->capacity;
+    return this->hash_function(key->c_str, this->capacity);
+}
+
 static void HashTable_insert_node(HashTable* this, Node* node){
-    uint32_t idx = this->hash_function(node->key, this->capacity);
+    uint32_t idx = HashTable_index(this, node->key);
     Node** table = this->table;
     while(1){
         if(table[idx]){
@@ -61,6 +69,9 @@ static void HashTable_insert_node(HashTable* this, Node* node){
 
 static int32_t HashTable_double_size(HashTable* this){
     HashTable* new_ht = HashTable_new_init_size(this->capacity * 2);
+    if(!new_ht)
+        return -1;
+    new_ht->hash_function = this->hash_function;
     uint32_t table_size = this->capacity;
     uint32_t element_count = this->taken_spaces;
     uint32_t elements_visited = 0;
@@ -131,7 +142,7 @@ void HashTable_destroy(HashTable* this){
     for(uint32_t i=0; (elements_visited<element_count) && (i<table_size); i++){
         if(table[i]){
             if(table[i]->deleted == 0)
-                free(table[i]->key);
+                Intern_release(table[i]->key);
             free(table[i]);
             elements_visited++;
         }
@@ -148,7 +159,7 @@ void HashTable_clear(HashTable* this){
     for(uint32_t i=0; (elements_visited<element_count) && (i<table_size); i++){
         if(table[i]){
             if(table[i]->deleted == 0)
-                free(table[i]->key);
+                Intern_release(table[i]->key);
             free(table[i]);
             table[i] = NULL;
             elements_visited++;
@@ -172,7 +183,7 @@ static void** HashTable_get_val_ref(HashTable* this, const char* key){
     Node** table = this->table;
     while(visited < this->size){
         if(table[idx]){
-            if((table[idx]->deleted == 0) && strcmp(key, table[idx]->key) == 0)
+            if((table[idx]->deleted == 0) && strcmp(key, table[idx]->key->c_str) == 0)
                 return &(table[idx]->data);
         }
         else
@@ -194,7 +205,11 @@ int32_t HashTable_insert(HashTable* this, const char* key, const void* value){
         *val_ref = (void*)value;
         return 0;
     }
-    Node* new_node = Node_new(key, value);
+    const InternStr* interned = Intern_c_str(key);
+    if(!interned)
+        return -1;
+    Node* new_node = Node_new(interned, value);
+    Intern_release(interned);
     if(!new_node)
         return -1;
     HashTable_insert_node(this, new_node);
@@ -209,7 +224,7 @@ void* HashTable_get(HashTable* this, const char* key){
     Node** table = this->table;
     while(visited < this->size){
         if(table[idx]){
-            if((table[idx]->deleted == 0) && strcmp(key, table[idx]->key) == 0)
+            if((table[idx]->deleted == 0) && strcmp(key, table[idx]->key->c_str) == 0)
                 return table[idx]->data;
         }
         else
@@ -227,9 +242,9 @@ void* HashTable_remove(HashTable* this, const char* key){
     Node** table = this->table;
     while(visited < this->size){
         if(table[idx]){
-            if((table[idx]->deleted == 0) && strcmp(key, table[idx]->key) == 0){
+            if((table[idx]->deleted == 0) && strcmp(key, table[idx]->key->c_str) == 0){
                 void* data = table[idx]->data;
-                free(table[idx]->key);
+                Intern_release(table[idx]->key);
                 table[idx]->deleted = 1;
                 this->size--;
                 return data;
@@ -250,7 +265,7 @@ int32_t HashTable_contains(HashTable* this, const char* key){
     Node** table = this->table;
     while(visited < this->size){
         if(table[idx]){
-            if((table[idx]->deleted == 0) && strcmp(key, table[idx]->key) == 0)
+            if((table[idx]->deleted == 0) && strcmp(key, table[idx]->key->c_str) == 0)
                 return 1;
         }
         else
@@ -262,6 +277,128 @@ int32_t HashTable_contains(HashTable* this, const char* key){
     return 0;
 }
 
+static Node** HashTable_find_interned(HashTable* this, const InternStr* key){
+    uint32_t idx = HashTable_index(this, key);
+    uint32_t visited = 0;
+    Node** table = this->table;
+    while(visited < this->size){
+        if(table[idx]){
+            if((table[idx]->deleted == 0) && (table[idx]->key == key))
+                return &table[idx];
+        }
+        else
+            break;
+        visited++;
+        idx++;
+        idx = idx % this->capacity;
+    }
+    return NULL;
+}
+
+int32_t HashTable_insert_interned(HashTable* this, const InternStr* key, const void* value){
+    if((double)this->taken_spaces / (double)this->capacity >= this->max_load_factor){
+        if(HashTable_double_size(this) == -1)
+            return -1;
+    }
+    Node** slot = HashTable_find_interned(this, key);
+    if(slot != NULL){
+        (*slot)->data = (void*)value;
+        return 0;
+    }
+    Node* new_node = Node_new(key, value);
+    if(!new_node)
+        return -1;
+    HashTable_insert_node(this, new_node);
+    this->size++;
+    this->taken_spaces++;
+    return 0;
+}
+
+void* HashTable_get_interned(HashTable* this, const InternStr* key){
+    Node** slot = HashTable_find_interned(this, key);
+    return slot ? (*slot)->data : NULL;
+}
+
+void* HashTable_remove_interned(HashTable* this, const InternStr* key){
+    Node** slot = HashTable_find_interned(this, key);
+    if(!slot)
+        return NULL;
+    void* data = (*slot)->data;
+    Intern_release((*slot)->key);
+    (*slot)->deleted = 1;
+    this->size--;
+    return data;
+}
+
+int32_t HashTable_contains_interned(HashTable* this, const InternStr* key){
+    return HashTable_find_interned(this, key) != NULL;
+}
+
+static Node** HashTable_find_str(HashTable* this, const String* key){
+    uint32_t hash = String_hash(key);
+    uint32_t length = String_len(key);
+    const char* c_str = String_data(key);
+    uint32_t idx = this->hash_function == def_hash_function ? hash % this->capacity : this->hash_function(c_str, this->capacity);
+    uint32_t visited = 0;
+    Node** table = this->table;
+    while(visited < this->size){
+        if(table[idx]){
+            const InternStr* node_key = table[idx]->key;
+            if((table[idx]->deleted == 0) && (node_key->hash == hash) && (node_key->length == length) && memcmp(c_str, node_key->c_str, length) == 0)
+                return &table[idx];
+        }
+        else
+            break;
+        visited++;
+        idx++;
+        idx = idx % this->capacity;
+    }
+    return NULL;
+}
+
+int32_t HashTable_insert_str(HashTable* this, const String* key, const void* value){
+    if((double)this->taken_spaces / (double)this->capacity >= this->max_load_factor){
+        if(HashTable_double_size(this) == -1)
+            return -1;
+    }
+    Node** slot = HashTable_find_str(this, key);
+    if(slot != NULL){
+        (*slot)->data = (void*)value;
+        return 0;
+    }
+    const InternStr* interned = Intern_n_hashed(String_data(key), String_len(key), String_hash(key));
+    if(!interned)
+        return -1;
+    Node* new_node = Node_new(interned, value);
+    Intern_release(interned);
+    if(!new_node)
+        return -1;
+    HashTable_insert_node(this, new_node);
+    this->size++;
+    this->taken_spaces++;
+    return 0;
+}
+
+void* HashTable_get_str(HashTable* this, const String* key){
+    Node** slot = HashTable_find_str(this, key);
+    return slot ? (*slot)->data : NULL;
+}
+
+void* HashTable_remove_str(HashTable* this, const String* key){
+    Node** slot = HashTable_find_str(this, key);
+    if(!slot)
+        return NULL;
+    void* data = (*slot)->data;
+    Intern_release((*slot)->key);
+    (*slot)->deleted = 1;
+    this->size--;
+    return data;
+}
+
+int32_t HashTable_contains_str(HashTable* this, const String* key){
+    return HashTable_find_str(this, key) != NULL;
+}
+
 void HashTable_map(HashTable* this, void (*func)(void* )){
     void* item;
     HT_for(this, item)
@@ -341,7 +478,7 @@ const char* HTKeyIterator_peak(HTKeyIterator* this) {
     while(this->index < this->hashtable->capacity){
         node = this->hashtable->table[this->index];
         if((node != NULL) && (node->deleted == 0))
-            return node->key;
+            return node->key->c_str;
         this->index++;
     }
     return NULL;
@@ -352,7 +489,7 @@ const char* HTKeyIterator_next(HTKeyIterator* this) {
     while(this->index < this->hashtable->capacity){
         node = this->hashtable->table[this->index++];
         if((node != NULL) && (node->deleted == 0))
-            return node->key;
+            return node->key->c_str;
     }
     return NULL;
 }
@@ -373,7 +510,7 @@ HTPair* HTPairIterator_peak(HTPairIterator* this){
     while(this->index < this->hashtable->capacity){
         node = this->hashtable->table[this->index];
         if((node != NULL) && (node->deleted == 0)){
-            this->pair.key = node->key;
+            this->pair.key = node->key->c_str;
             this->pair.value = node->data;
             return &(this->pair);
         }
@@ -387,7 +524,7 @@ HTPair* HTPairIterator_next(HTPairIterator* this){
     while(this->index < this->hashtable->capacity){
         node = this->hashtable->table[this->index++];
         if((node != NULL) && (node->deleted == 0)){
-            this->pair.key = node->key;
+            this->pair.key = node->key->c_str;
             this->pair.value = node->data;
             return &(this->pair);
         }
@@ -9,6 +9,8 @@
 
 /* Opaque types */
 typedef struct HashTable HashTable;
+typedef struct InternStr InternStr;
+typedef struct String String;
 
 /* Types */
 typedef struct HTPair {
@@ -47,6 +49,16 @@ void* HashTable_remove(HashTable* this, const char* key);
 int32_t HashTable_set_max_load_factor(HashTable* this, double max_load_factor);
 double HashTable_get_max_load_factor(HashTable* this);
 double HashTable_get_current_load_factor(HashTable* this);
+/* Same as above for keys that are already interned: no hashing and a pointer compare per probe */
+int32_t HashTable_insert_interned(HashTable* this, const InternStr* key, const void* value);
+void* HashTable_get_interned(HashTable* this, const InternStr* key);
+void* HashTable_remove_interned(HashTable* this, const InternStr* key);
+int32_t HashTable_contains_interned(HashTable* this, const InternStr* key);
+/* String keys: the String's cached hash is reused, and keys are compared by length first */
+int32_t HashTable_insert_str(HashTable* this, const String* key, const void* value);
+void* HashTable_get_str(HashTable* this, const String* key);
+void* HashTable_remove_str(HashTable* this, const String* key);
+int32_t HashTable_contains_str(HashTable* this, const String* key);
 void HashTable_map(HashTable* this, void (*func)(void* ));
 void HashTable_serialize(HashTable* this, FILE* fp, void (*value_serializer)(FILE* fp, void* value));
 HashTable* HashTable_deserialize(FILE* fp, void* (*value_deserializer)(FILE* fp));
@@ -0,0 +1,242 @@
+#include "ConcurrentHashSet.h"
+#include <stdatomic.h>
+#include <string.h>
+#include <stdlib.h>
+
+#define CACHE_LINE 64
+
+static const uint32_t DEF_EXPECTED_ELEMENTS = 4096;
+static const double DEF_MAX_LOAD_FACTOR = 0.7;
+
+/* Open addressing with linear probing over two parallel arrays.
+ * A slot is claimed by a single CAS of its key from NULL; the key's hash is
+ * published right after and is only used as a filter before strcmp. Slots are
+ * never emptied, so a probe sequence that reaches an empty slot proves absence. */
+struct ConcurrentHashSet {
+    uint32_t capacity;              /* power of 2 */
+    uint32_t max_elements;
+    double max_load_factor;
+    _Atomic(const char*)* keys;
+    _Atomic(uint32_t)* hashes;      /* 0 until the slot owner publishes it */
+    uint32_t (*hash_function)(const char* );
+    _Alignas(CACHE_LINE) atomic_uint_fast32_t element_count;
+};
+
+static uint32_t def_hash_function(const char* key){
+    static const uint32_t HASH_MUTLIPLIER = 65599;
+    uint32_t hash_value = 0;
+    while(*key)
+        hash_value = hash_value * HASH_MUTLIPLIER + *key++;
+    /* the table is masked, not reduced modulo a prime, so mix the high bits down */
+    hash_value ^= hash_value >> 16;
+    hash_value *= 0x85ebca6b;
+    hash_value ^= hash_value >> 13;
+    hash_value *= 0xc2b2ae35;
+    hash_value ^= hash_value >> 16;
+    return hash_value;
+}
+
+static uint32_t capacity_for(uint32_t expected_elements, double max_load_factor){
+    uint64_t needed = (uint64_t)(expected_elements / max_load_factor) + 1;
+    uint64_t capacity = 16;
+    while(capacity < needed)
+        capacity <<= 1;
+    return capacity > (1u << 31) ? 0 : (uint32_t)capacity;
+}
+
+static int32_t ConcurrentHashSet_alloc_table(ConcurrentHashSet* this, uint32_t capacity){
+    if(capacity == 0)
+        return -1;
+    _Atomic(const char*)* keys = calloc(capacity, sizeof(*keys));
+    _Atomic(uint32_t)* hashes = calloc(capacity, sizeof(*hashes));
+    if(!keys || !hashes){
+        free(keys);
+        free(hashes);
+        return -1;
+    }
+    this->keys = keys;
+    this->hashes = hashes;
+    this->capacity = capacity;
+    this->max_elements = capacity * this->max_load_factor;
+    return 0;
+}
+
+ConcurrentHashSet* ConcurrentHashSet_new(void){
+    return ConcurrentHashSet_new_init_size(DEF_EXPECTED_ELEMENTS);
+}
+
+ConcurrentHashSet* ConcurrentHashSet_new_init_size(uint32_t expected_elements){
+    ConcurrentHashSet* this = aligned_alloc(CACHE_LINE, sizeof(ConcurrentHashSet));
+    if(!this)
+        return NULL;
+    this->hash_function = def_hash_function;
+    this->max_load_factor = DEF_MAX_LOAD_FACTOR;
+    atomic_init(&this->element_count, 0);
+    if(ConcurrentHashSet_alloc_table(this, capacity_for(expected_elements, DEF_MAX_LOAD_FACTOR)) == -1){
+        free(this);
+        return NULL;
+    }
+    return this;
+}
+
+// don't call if not empty :)
+void ConcurrentHashSet_set_hash_function(ConcurrentHashSet* this, uint32_t (*new_hash_function)(const char* key)){
+    this->hash_function = new_hash_function;
+}
+
+int32_t ConcurrentHashSet_set_max_load_factor(ConcurrentHashSet* this, double max_load_factor){
+    if(max_load_factor >= 1.0 || max_load_factor <= 0)
+        return -1;
+    this->max_load_factor = max_load_factor;
+    this->max_elements = this->capacity * max_load_factor;
+    return 0;
+}
+
+double ConcurrentHashSet_get_max_load_factor(ConcurrentHashSet* this){
+    return this->max_load_factor;
+}
+
+double ConcurrentHashSet_get_current_load_factor(ConcurrentHashSet* this){
+    return (double)ConcurrentHashSet_element_count(this) / (double)this->capacity;
+}
+
+void ConcurrentHashSet_destroy(ConcurrentHashSet* this){
+    free((void*)this->keys);
+    free((void*)this->hashes);
+    free(this);
+}
+
+void ConcurrentHashSet_clear(ConcurrentHashSet* this){
+    memset((void*)this->keys, 0, this->capacity * sizeof(*this->keys));
+    memset((void*)this->hashes, 0, this->capacity * sizeof(*this->hashes));
+    atomic_store(&this->element_count, 0);
+}
+
+uint32_t ConcurrentHashSet_capacity(ConcurrentHashSet* this){
+    return this->capacity;
+}
+
+uint32_t ConcurrentHashSet_element_count(ConcurrentHashSet* this){
+    return atomic_load_explicit(&this->element_count, memory_order_relaxed);
+}
+
+static inline uint32_t ConcurrentHashSet_hash(ConcurrentHashSet* this, const char* key){
+    return this->hash_function(key) | 1;    /* 0 marks an unpublished hash */
+}
+
+/* Compares the key stored in slot idx against key. Until the owner publishes the
+ * slot's hash (stored_hash == 0) the strings have to be compared. */
+static inline bool slot_matches(ConcurrentHashSet* this, uint32_t idx, const char* stored, const char* key, uint32_t hash){
+    uint32_t stored_hash = atomic_load_explicit(&this->hashes[idx], memory_order_acquire);
+    if(stored_hash != 0 && stored_hash != hash)
+        return false;
+    return stored == key || strcmp(stored, key) == 0;
+}
+
+int32_t ConcurrentHashSet_contains(ConcurrentHashSet* this, const char* key){
+    uint32_t hash = ConcurrentHashSet_hash(this, key);
+    uint32_t mask = this->capacity - 1;
+    uint32_t idx = hash & mask;
+    for(uint32_t probes=0; probes<this->capacity; probes++){
+        const char* stored = atomic_load_explicit(&this->keys[idx], memory_order_acquire);
+        if(stored == NULL)
+            return 0;
+        if(slot_matches(this, idx, stored, key, hash))
+            return 1;
+        idx = (idx + 1) & mask;
+    }
+    return 0;
+}
+
+/* Returns 1 if the caller's key was inserted, 0 if an equal key was already
+ * present (possibly inserted concurrently) and -1 if the set is full.
+ * The set stores the key pointer; it never copies or frees keys. */
+int32_t ConcurrentHashSet_insert(ConcurrentHashSet* this, const char* key){
+    uint32_t hash = ConcurrentHashSet_hash(this, key);
+    uint32_t mask = this->capacity - 1;
+    uint32_t idx = hash & mask;
+    for(uint32_t probes=0; probes<this->capacity; probes++){
+        const char* stored = atomic_load_explicit(&this->keys[idx], memory_order_acquire);
+        if(stored == NULL){
+            if(atomic_load_explicit(&this->element_count, memory_order_relaxed) >= this->max_elements)
+                return -1;
+            if(atomic_compare_exchange_strong_explicit(&this->keys[idx], &stored, key,
+                                                       memory_order_acq_rel, memory_order_acquire)){
+                atomic_store_explicit(&this->hashes[idx], hash, memory_order_release);
+                atomic_fetch_add_explicit(&this->element_count, 1, memory_order_relaxed);
+                return 1;
+            }
+            /* lost the slot, stored now holds the winner's key */
+        }
+        if(slot_matches(this, idx, stored, key, hash))
+            return 0;
+        idx = (idx + 1) & mask;
+    }
+    return -1;
+}
+
+/* Rehashes into a table sized for expected_elements. Not thread safe: callers either
+ * pre-size the set, or stop their workers, grow and restart them when insert returns -1. */
+int32_t ConcurrentHashSet_grow(ConcurrentHashSet* this, uint32_t expected_elements){
+    uint32_t new_capacity = capacity_for(expected_elements, this->max_load_factor);
+    if(new_capacity <= this->capacity)
+        return 0;
+    uint32_t old_capacity = this->capacity;
+    _Atomic(const char*)* old_keys = this->keys;
+    _Atomic(uint32_t)* old_hashes = this->hashes;
+    if(ConcurrentHashSet_alloc_table(this, new_capacity) == -1)
+        return -1;
+    uint32_t mask = new_capacity - 1;
+    for(uint32_t i=0; i<old_capacity; i++){
+        const char* key = old_keys[i];
+        if(key == NULL)
+            continue;
+        uint32_t hash = old_hashes[i] ? old_hashes[i] : ConcurrentHashSet_hash(this, key);
+        uint32_t idx = hash & mask;
+        while(this->keys[idx] != NULL)
+            idx = (idx + 1) & mask;
+        this->keys[idx] = key;
+        this->hashes[idx] = hash;
+    }
+    free((void*)old_keys);
+    free((void*)old_hashes);
+    return 0;
+}
+
+void ConcurrentHashSet_map(ConcurrentHashSet* this, void (*func)(void* )){
+    const char* key;
+    CHS_for(this, key)
+        func((void*)key);
+}
+
+CHSIterator CHSIterator_new(ConcurrentHashSet* set){
+    return (CHSIterator) {
+        .set = set,
+        .index = 0
+    };
+}
+
+const char* CHSIterator_peak(CHSIterator* this){
+    const char* key;
+    while(this->index < this->set->capacity){
+        key = this->set->keys[this->index];
+        if(key != NULL)
+            return key;
+        this->index++;
+    }
+    return NULL;
+}
+
+const char* CHSIterator_next(CHSIterator* this){
+    const char* key;
+    while(this->index < this->set->capacity){
+        key = this->set->keys[this->index++];
+        if(key != NULL)
+            return key;
+    }
+    return NULL;
+}
+
+void CHSIterator_reset(CHSIterator* this){
+    this->index = 0;
+}
@@ -0,0 +1,47 @@
+#ifndef _MY_CONCURRENT_HASH_SET_
+#define _MY_CONCURRENT_HASH_SET_
+#include <inttypes.h>
+#include <stdbool.h>
+
+#define _MERGE_(prefix, num) prefix##num
+#define _LABEL_(num) _MERGE_(_uniq_, num)
+#define _UNIQUE_ID_ _LABEL_(__COUNTER__)
+
+/* Opaque types */
+typedef struct ConcurrentHashSet ConcurrentHashSet;
+
+/* Types */
+typedef struct CHSIterator {
+    ConcurrentHashSet* set;
+    uint32_t index;
+} CHSIterator;
+
+/* ConcurrentHashSet methods
+ * insert and contains may be called from any number of threads at once.
+ * Everything else (destroy, clear, grow, set_*, map, iterators) needs the set to be quiescent. */
+ConcurrentHashSet* ConcurrentHashSet_new(void);
+ConcurrentHashSet* ConcurrentHashSet_new_init_size(uint32_t expected_elements);
+void ConcurrentHashSet_set_hash_function(ConcurrentHashSet* this, uint32_t (*new_hash_function)(const char* key));
+void ConcurrentHashSet_destroy(ConcurrentHashSet* this);
+void ConcurrentHashSet_clear(ConcurrentHashSet* this);
+uint32_t ConcurrentHashSet_capacity(ConcurrentHashSet* this);
+uint32_t ConcurrentHashSet_element_count(ConcurrentHashSet* this);
+int32_t ConcurrentHashSet_contains(ConcurrentHashSet* this, const char* key);
+int32_t ConcurrentHashSet_insert(ConcurrentHashSet* this, const char* key);
+int32_t ConcurrentHashSet_grow(ConcurrentHashSet* this, uint32_t expected_elements);
+int32_t ConcurrentHashSet_set_max_load_factor(ConcurrentHashSet* this, double max_load_factor);
+double ConcurrentHashSet_get_max_load_factor(ConcurrentHashSet* this);
+double ConcurrentHashSet_get_current_load_factor(ConcurrentHashSet* this);
+void ConcurrentHashSet_map(ConcurrentHashSet* this, void (*func)(void* ));
+
+/* CHSIterator methods + macro */
+CHSIterator CHSIterator_new(ConcurrentHashSet* set);
+const char* CHSIterator_peak(CHSIterator* this);
+const char* CHSIterator_next(CHSIterator* this);
+void CHSIterator_reset(CHSIterator* this);
+
+#define _CHS_for_(_hset, _val, unique_id) for (CHSIterator unique_id = CHSIterator_new(_hset); (_val = CHSIterator_next(&unique_id)) != NULL; )
+#define CHS_for(hset, val) _CHS_for_(hset, val, _UNIQUE_ID_)
+
+
+#endif
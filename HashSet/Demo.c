@@ -1,4 +1,5 @@
 #include "HashSet.h"
+#include "../String/String.h"
 #include <stdio.h>
 
 int main(int argc, const char* argv[]) {
@@ -19,5 +20,20 @@ int main(int argc, const char* argv[]) {
         printf("=> %f <=\n", *data);
 
     HashSet_destroy(hset);
+
+    /* String elements, compared by value */
+    const char* text[] = {"to", "be", "or", "not", "to", "be"};
+    String* words[6];
+    HashSet* distinct = HashSet_new_str();
+    for(int i=0; i<6; i++){
+        words[i] = String_new_copy(text[i]);
+        HashSet_insert_str(distinct, words[i]);
+    }
+    printf("distinct words: %u\n", HashSet_element_count(distinct));
+    HashSet_remove_str(distinct, words[3]);
+    printf("contains \"not\": %d, contains \"be\": %d\n", HashSet_contains_str(distinct, words[3]), HashSet_contains_str(distinct, words[1]));
+    HashSet_destroy(distinct);
+    for(int i=0; i<6; i++)
+        String_destroy(words[i]);
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,51 @@
+#include "ConcurrentHashSet.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define THREADS 4
+#define URLS_PER_THREAD 200000
+#define DISTINCT_URLS 300000
+
+typedef struct Worker {
+    ConcurrentHashSet* seen;
+    uint32_t seed;
+    uint32_t won;
+} Worker;
+
+// every worker "crawls" random urls out of the same pool, most of them already seen by someone
+void* crawl(void* arg) {
+    Worker* worker = arg;
+    for (uint32_t i = 0; i < URLS_PER_THREAD; i++) {
+        char* url = malloc(48);
+        sprintf(url, "https://example.com/page/%d", rand_r(&worker->seed) % DISTINCT_URLS);
+        if (ConcurrentHashSet_insert(worker->seen, url) == 1)
+            worker->won++;      // the set keeps our copy
+        else
+            free(url);
+    }
+    return NULL;
+}
+
+int main(int argc, const char* argv[]) {
+    ConcurrentHashSet* seen = ConcurrentHashSet_new_init_size(DISTINCT_URLS);
+    pthread_t threads[THREADS];
+    Worker workers[THREADS];
+
+    for (int i = 0; i < THREADS; i++) {
+        workers[i] = (Worker) { .seen = seen, .seed = i + 1, .won = 0 };
+        pthread_create(&threads[i], NULL, crawl, &workers[i]);
+    }
+    uint32_t won = 0;
+    for (int i = 0; i < THREADS; i++) {
+        pthread_join(threads[i], NULL);
+        printf("worker %d: %u new urls\n", i, workers[i].won);
+        won += workers[i].won;
+    }
+    printf("distinct urls: %u (sum of wins: %u)\n", ConcurrentHashSet_element_count(seen), won);
+    printf("contains page/7: %d\n", ConcurrentHashSet_contains(seen, "https://example.com/page/7"));
+
+    ConcurrentHashSet_map(seen, free);
+    ConcurrentHashSet_destroy(seen);
+    return 0;
+}
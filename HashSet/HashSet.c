@@ -1,4 +1,5 @@
 #include "HashSet.h"
+#include "../String/String.h"
 #include <string.h>
 #include <stdlib.h>
 
@@ -19,6 +20,7 @@ struct HashSet {
     double max_load_factor;
     Node **table;
     uint32_t (*hash_function)(const void* , uint32_t);
+    bool str_keys;      /* elements are String*, hashed with their cached String_hash */
 };
 
 
@@ -34,13 +36,21 @@ static uint32_t def_hash_function(const void* data, uint32_t table_size){
 
 static Node* Node_new(void* data){
     Node* this = malloc(sizeof(Node));
+    if(!this)
+        return NULL;
     this->data = data;
     this->deleted = 0;
     return this;
 }
 
+static inline uint32_t HashSet_index(HashSet* this, const void* data){
+    if(this->str_keys)
+        return String_hash(data) % this->table_size;
+    return this->hash_function(data, this->table_size);
+}
+
 static void HashSet_insert_node(HashSet* this, Node* node){
-    uint32_t idx = this->hash_function(node->data, this->table_size);
+    uint32_t idx = HashSet_index(this, node->data);
     Node** table = this->table;
     while(1){
         if(table[idx]){
@@ -61,6 +71,10 @@ static void HashSet_insert_node(HashSet* this, Node* node){
 
 static int32_t HashSet_double_size(HashSet* this){
     HashSet* new_ht = HashSet_new_init_size(this->table_size * 2);
+    if(!new_ht)
+        return -1;
+    new_ht->hash_function = this->hash_function;
+    new_ht->str_keys = this->str_keys;
     uint32_t table_size = this->table_size;
     uint32_t element_count = this->taken_spaces;
     uint32_t elements_visited = 0;
@@ -86,11 +100,19 @@ HashSet* HashSet_new(void){
     return HashSet_new_init_size(DEF_SIZE);
 }
 
+HashSet* HashSet_new_str(void){
+    HashSet* this = HashSet_new_init_size(DEF_SIZE);
+    if(this)
+        this->str_keys = true;
+    return this;
+}
+
 HashSet* HashSet_new_init_size(uint32_t init_size){
     HashSet* this = malloc(sizeof(HashSet));
     if(!this) 
         return NULL;
     this->hash_function = def_hash_function;
+    this->str_keys = false;
     this->table_size = init_size;
     this->element_count = 0;
     this->taken_spaces = 0;
@@ -144,7 +166,7 @@ void HashSet_clear(HashSet* this){
     Node** table = this->table;
     for(uint32_t i=0; (elements_visited<element_count) && (i<table_size); i++){
         if(table[i]){
-            if(table[i]->deleted == 0)
+            if(table[i]->deleted == 0 && !this->str_keys)
                 free(table[i]->data);
             free(table[i]);
             table[i] = NULL;
@@ -241,6 +263,57 @@ int32_t HashSet_contains(HashSet* this, void* key){
     return 0;
 }
 
+static Node** HashSet_find_str(HashSet* this, const String* str){
+    uint32_t idx = HashSet_index(this, str);
+    uint32_t visited = 0;
+    Node** table = this->table;
+    while(visited < this->element_count){
+        if(table[idx]){
+            if((table[idx]->deleted == 0) && String_is_equal(str, table[idx]->data))
+                return &table[idx];
+        }
+        else
+            break;
+        visited++;
+        idx++;
+        idx = idx % this->table_size;
+    }
+    return NULL;
+}
+
+int32_t HashSet_insert_str(HashSet* this, String* str){
+    if((double)this->taken_spaces / (double)this->table_size >= this->max_load_factor){
+        if(HashSet_double_size(this) == -1)
+            return -1;
+    }
+    Node** slot = HashSet_find_str(this, str);
+    if(slot != NULL){
+        (*slot)->data = str;
+        return 0;
+    }
+    Node* new_node = Node_new(str);
+    if(!new_node)
+        return -1;
+    HashSet_insert_node(this, new_node);
+    this->element_count++;
+    this->taken_spaces++;
+    return 0;
+}
+
+/* Returns the element equal to str, which the set doesn't free */
+String* HashSet_remove_str(HashSet* this, const String* str){
+    Node** slot = HashSet_find_str(this, str);
+    if(!slot)
+        return NULL;
+    (*slot)->deleted = 1;
+    this->element_count--;
+    return (*slot)->data;
+}
+
+int32_t HashSet_contains_str(HashSet* this, const String* str){
+    return HashSet_find_str(this, str) != NULL;
+}
+
 void HashSet_map(HashSet* this, void (*func)(void* )){
     void* item;
     HS_for(this, item)
@@ -9,6 +9,7 @@
 
 /* Opaque types */
 typedef struct HashSet HashSet;
+typedef struct String String;
 
 /* Types */
 typedef struct HSIterator {
@@ -31,6 +32,13 @@ int32_t HashSet_set_max_load_factor(HashSet* this, double max_load_factor);
 double HashSet_get_max_load_factor(HashSet* this);
 double HashSet_get_current_load_factor(HashSet* this);
 void HashSet_map(HashSet* this, void (*func)(void* ));
+/* A set made by HashSet_new_str holds String* elements (../String) and is used through the
+ * _str methods only. Elements are hashed with their cached String_hash and compared by
+ * length first. They are not owned, clear and remove_str leave them alone. */
+HashSet* HashSet_new_str(void);
+int32_t HashSet_insert_str(HashSet* this, String* str);
+String* HashSet_remove_str(HashSet* this, const String* str);
+int32_t HashSet_contains_str(HashSet* this, const String* str);
 
 /* HSIterator methods + macro */
 HSIterator HSIterator_new(HashSet* HashSet);
@@ -0,0 +1,47 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "HyperLogLog.h"
+
+void fill(HyperLogLog* hll, uint64_t from, uint64_t to) {
+    char key[32];
+    for (uint64_t i = from; i < to; i++) {
+        int len = sprintf(key, "user-%lu", i);
+        HyperLogLog_add(hll, key, len);
+    }
+}
+
+void report(const char* name, HyperLogLog* hll, uint64_t exact) {
+    uint64_t estimate = HyperLogLog_count(hll);
+    printf("%-8s exact: %9lu  estimate: %9lu  error: %+.3f%%  (%s)\n", name, exact, estimate,
+        100.0 * ((double)estimate - (double)exact) / (double)exact,
+        HyperLogLog_is_sparse(hll) ? "sparse" : "dense");
+}
+
+int main(int argc, const char* argv[]) {
+    HyperLogLog* a = HyperLogLog_new();
+    HyperLogLog* b = HyperLogLog_new();
+    printf("precision: %u, standard error: %.3f%%\n", HyperLogLog_precision(a), 100 * HyperLogLog_standard_error(a));
+
+    fill(a, 0, 1000);
+    fill(a, 0, 1000);   // duplicates don't count
+    report("a", a, 1000);
+
+    fill(b, 500, 2000000);
+    report("b", b, 2000000 - 500);
+
+    // per-thread sketches are combined with merge
+    HyperLogLog_merge(a, b);
+    report("a | b", a, 2000000);
+
+    FILE* fp = tmpfile();
+    HyperLogLog_serialize(a, fp);
+    rewind(fp);
+    HyperLogLog* c = HyperLogLog_deserialize(fp);
+    fclose(fp);
+    report("restored", c, 2000000);
+
+    HyperLogLog_destroy(a);
+    HyperLogLog_destroy(b);
+    HyperLogLog_destroy(c);
+    return 0;
+}
@@ -0,0 +1,390 @@
+#include "HyperLogLog.h"
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+/* Sparse entries are (index << 6 | rho) pairs computed with SPARSE_PRECISION index bits,
+ * so that small cardinalities are estimated with linear counting over 2^25 buckets. */
+#define SPARSE_PRECISION 25
+#define SPARSE_RHO_BITS 6
+#define SPARSE_TMP_LEN 256
+
+struct HyperLogLog {
+    uint8_t precision;
+    uint32_t register_count;
+    uint8_t* registers;             /* NULL while sparse */
+    uint32_t* sparse;               /* sorted, one entry per index */
+    uint32_t sparse_len, sparse_capacity;
+    uint32_t tmp[SPARSE_TMP_LEN];   /* unsorted insertion buffer, merged into sparse when full */
+    uint32_t tmp_len;
+};
+
+static inline uint64_t rotl64(uint64_t x, int r){
+    return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t fmix64(uint64_t k){
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return k;
+}
+
+uint64_t HyperLogLog_hash(const void* data, size_t len){
+    static const uint64_t C1 = 0x87c37b91114253d5ULL;
+    static const uint64_t C2 = 0x4cf5ad432745937fULL;
+    const unsigned char* bytes = data;
+    uint64_t h = 0x9e3779b97f4a7c15ULL ^ (len * C1);
+    uint64_t k;
+    while(len >= 8){
+        memcpy(&k, bytes, 8);
+        k *= C1;
+        k = rotl64(k, 31);
+        k *= C2;
+        h ^= k;
+        h = rotl64(h, 27) * 5 + 0x52dce729;
+        bytes += 8;
+        len -= 8;
+    }
+    k = 0;
+    for(size_t i=0; i<len; i++)
+        k |= (uint64_t)bytes[i] << (8 * i);
+    k *= C1;
+    k = rotl64(k, 31);
+    k *= C2;
+    h ^= k;
+    return fmix64(h);
+}
+
+static inline uint8_t leading_zeros64(uint64_t x){
+    return x ? (uint8_t)__builtin_clzll(x) : 64;
+}
+
+static inline uint32_t sparse_encode(uint64_t hash){
+    uint32_t idx = hash >> (64 - SPARSE_PRECISION);
+    uint8_t rho = leading_zeros64(hash << SPARSE_PRECISION) + 1;
+    if(rho > 64 - SPARSE_PRECISION + 1)
+        rho = 64 - SPARSE_PRECISION + 1;
+    return (idx << SPARSE_RHO_BITS) | rho;
+}
+
+/* Maps a sparse entry to its dense register index and value for the given precision */
+static inline void sparse_decode(uint32_t entry, uint8_t precision, uint32_t* idx, uint8_t* rho){
+    uint32_t sparse_idx = entry >> SPARSE_RHO_BITS;
+    uint8_t extra_bits = SPARSE_PRECISION - precision;
+    uint32_t low = sparse_idx & ((1u << extra_bits) - 1);
+    *idx = sparse_idx >> extra_bits;
+    if(low)
+        *rho = (uint8_t)(__builtin_clz(low) - (32 - extra_bits) + 1);
+    else
+        *rho = extra_bits + (entry & ((1u << SPARSE_RHO_BITS) - 1));
+}
+
+static int cmp_uint32(const void* a, const void* b){
+    uint32_t x = *(const uint32_t*)a, y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+/* Sorts the insertion buffer and merges it into the sparse list,
+ * keeping only the largest rho of every index. */
+static int HyperLogLog_sparse_flush(HyperLogLog* this){
+    if(this->tmp_len == 0)
+        return 0;
+    qsort(this->tmp, this->tmp_len, sizeof(uint32_t), cmp_uint32);
+    uint32_t needed = this->sparse_len + this->tmp_len;
+    if(needed > this->sparse_capacity){
+        uint32_t new_capacity = this->sparse_capacity ? this->sparse_capacity * 2 : SPARSE_TMP_LEN;
+        while(new_capacity < needed)
+            new_capacity *= 2;
+        uint32_t* new_sparse = realloc(this->sparse, new_capacity * sizeof(uint32_t));
+        if(!new_sparse)
+            return -1;
+        this->sparse = new_sparse;
+        this->sparse_capacity = new_capacity;
+    }
+    /* merge from the back so that the sparse list can be reused as output */
+    uint32_t* out = this->sparse;
+    int64_t i = (int64_t)this->sparse_len - 1, j = (int64_t)this->tmp_len - 1, k = needed - 1;
+    while(j >= 0){
+        if(i >= 0 && out[i] > this->tmp[j])
+            out[k--] = out[i--];
+        else
+            out[k--] = this->tmp[j--];
+    }
+    /* dedupe: entries with the same index are adjacent and ordered by rho, keep the last */
+    uint32_t len = 0;
+    for(uint32_t idx=0; idx<needed; idx++){
+        if(len > 0 && (out[len - 1] >> SPARSE_RHO_BITS) == (out[idx] >> SPARSE_RHO_BITS))
+            out[len - 1] = out[idx];
+        else
+            out[len++] = out[idx];
+    }
+    this->sparse_len = len;
+    this->tmp_len = 0;
+    return 0;
+}
+
+static int HyperLogLog_to_dense(HyperLogLog* this){
+    if(HyperLogLog_sparse_flush(this) == -1)
+        return -1;
+    uint8_t* registers = calloc(this->register_count, sizeof(uint8_t));
+    if(!registers)
+        return -1;
+    uint32_t idx;
+    uint8_t rho;
+    for(uint32_t i=0; i<this->sparse_len; i++){
+        sparse_decode(this->sparse[i], this->precision, &idx, &rho);
+        if(rho > registers[idx])
+            registers[idx] = rho;
+    }
+    free(this->sparse);
+    this->sparse = NULL;
+    this->sparse_len = 0;
+    this->sparse_capacity = 0;
+    this->registers = registers;
+    return 0;
+}
+
+static inline void HyperLogLog_dense_add(HyperLogLog* this, uint64_t hash){
+    uint8_t precision = this->precision;
+    uint32_t idx = hash >> (64 - precision);
+    uint8_t rho = leading_zeros64((hash << precision) | (1ULL << (precision - 1))) + 1;
+    if(rho > this->registers[idx])
+        this->registers[idx] = rho;
+}
+
+/* The sparse list is given up once it would take more memory than the dense registers */
+static inline bool HyperLogLog_sparse_full(HyperLogLog* this){
+    return this->sparse_len * sizeof(uint32_t) > this->register_count;
+}
+
+static int HyperLogLog_sparse_add(HyperLogLog* this, uint32_t entry){
+    this->tmp[this->tmp_len++] = entry;
+    if(this->tmp_len < SPARSE_TMP_LEN)
+        return 0;
+    if(HyperLogLog_sparse_flush(this) == -1)
+        return -1;
+    if(HyperLogLog_sparse_full(this))
+        return HyperLogLog_to_dense(this);
+    return 0;
+}
+
+HyperLogLog* HyperLogLog_new(void){
+    return HyperLogLog_new_precision(HLL_DEF_PRECISION);
+}
+
+HyperLogLog* HyperLogLog_new_precision(uint8_t precision){
+    if(precision < HLL_MIN_PRECISION || precision > HLL_MAX_PRECISION)
+        return NULL;
+    HyperLogLog* this = malloc(sizeof(HyperLogLog));
+    if(!this)
+        return NULL;
+    this->precision = precision;
+    this->register_count = 1u << precision;
+    this->registers = NULL;
+    this->sparse = NULL;
+    this->sparse_len = 0;
+    this->sparse_capacity = 0;
+    this->tmp_len = 0;
+    return this;
+}
+
+HyperLogLog* HyperLogLog_clone(HyperLogLog* this){
+    HyperLogLog* clone = HyperLogLog_new_precision(this->precision);
+    if(!clone)
+        return NULL;
+    if(HyperLogLog_merge(clone, this) == -1){
+        HyperLogLog_destroy(clone);
+        return NULL;
+    }
+    return clone;
+}
+
+void HyperLogLog_destroy(HyperLogLog* this){
+    free(this->registers);
+    free(this->sparse);
+    free(this);
+}
+
+void HyperLogLog_clear(HyperLogLog* this){
+    free(this->registers);
+    free(this->sparse);
+    this->registers = NULL;
+    this->sparse = NULL;
+    this->sparse_len = 0;
+    this->sparse_capacity = 0;
+    this->tmp_len = 0;
+}
+
+uint8_t HyperLogLog_precision(HyperLogLog* this){
+    return this->precision;
+}
+
+bool HyperLogLog_is_sparse(HyperLogLog* this){
+    return this->registers == NULL;
+}
+
+double HyperLogLog_standard_error(HyperLogLog* this){
+    return 1.04 / sqrt((double)this->register_count);
+}
+
+int HyperLogLog_add_hash(HyperLogLog* this, uint64_t hash){
+    if(this->registers){
+        HyperLogLog_dense_add(this, hash);
+        return 0;
+    }
+    return HyperLogLog_sparse_add(this, sparse_encode(hash));
+}
+
+int HyperLogLog_add(HyperLogLog* this, const void* data, size_t len){
+    return HyperLogLog_add_hash(this, HyperLogLog_hash(data, len));
+}
+
+int HyperLogLog_add_c_str(HyperLogLog* this, const char* c_str){
+    return HyperLogLog_add_hash(this, HyperLogLog_hash(c_str, strlen(c_str)));
+}
+
+/* Ertl, "New cardinality estimation algorithms for HyperLogLog sketches" (2017).
+ * Unbiased over the whole range, so no bias tables or linear counting switch are needed. */
+static double ertl_sigma(double x){
+    if(x == 1.0)
+        return INFINITY;
+    double y = 1.0, z = x, z_prev;
+    do {
+        x *= x;
+        z_prev = z;
+        z += x * y;
+        y += y;
+    } while(z != z_prev);
+    return z;
+}
+
+static double ertl_tau(double x){
+    if(x == 0.0 || x == 1.0)
+        return 0.0;
+    double y = 1.0, z = 1.0 - x, z_prev;
+    do {
+        x = sqrt(x);
+        z_prev = z;
+        y *= 0.5;
+        z -= (1.0 - x) * (1.0 - x) * y;
+    } while(z != z_prev);
+    return z / 3.0;
+}
+
+static uint64_t HyperLogLog_dense_count(HyperLogLog* this){
+    uint32_t histogram[64 + 2] = { 0 };
+    uint8_t q = 64 - this->precision;
+    double m = this->register_count;
+    for(uint32_t i=0; i<this->register_count; i++)
+        histogram[this->registers[i]]++;
+    double z = m * ertl_tau(1.0 - histogram[q + 1] / m);
+    for(int k=q; k>=1; k--)
+        z = 0.5 * (z + histogram[k]);
+    z += m * ertl_sigma(histogram[0] / m);
+    return (uint64_t)llround((m * m) / (2.0 * M_LN2 * z));
+}
+
+uint64_t HyperLogLog_count(HyperLogLog* this){
+    if(this->registers)
+        return HyperLogLog_dense_count(this);
+    if(HyperLogLog_sparse_flush(this) == -1)
+        return this->sparse_len;
+    double m = (double)(1u << SPARSE_PRECISION);
+    return (uint64_t)llround(m * log(m / (m - this->sparse_len)));
+}
+
+int HyperLogLog_merge(HyperLogLog* this, HyperLogLog* other){
+    if(this->precision != other->precision)
+        return -1;
+    if(other->registers){
+        if(!this->registers && HyperLogLog_to_dense(this) == -1)
+            return -1;
+        uint8_t* dst = this->registers;
+        const uint8_t* src = other->registers;
+        for(uint32_t i=0; i<this->register_count; i++)
+            dst[i] = src[i] > dst[i] ? src[i] : dst[i];
+        return 0;
+    }
+    if(HyperLogLog_sparse_flush(other) == -1)
+        return -1;
+    for(uint32_t i=0; i<other->sparse_len; i++){
+        if(this->registers){
+            uint32_t idx;
+            uint8_t rho;
+            sparse_decode(other->sparse[i], this->precision, &idx, &rho);
+            if(rho > this->registers[idx])
+                this->registers[idx] = rho;
+        }
+        else if(HyperLogLog_sparse_add(this, other->sparse[i]) == -1)
+            return -1;
+    }
+    return 0;
+}
+
+void HyperLogLog_serialize(HyperLogLog* this, FILE* fp){
+    uint8_t is_sparse = this->registers == NULL;
+    if(is_sparse && HyperLogLog_sparse_flush(this) == -1)
+        is_sparse = HyperLogLog_to_dense(this) == -1;
+    fwrite(&(this->precision), sizeof(this->precision), 1, fp);
+    fwrite(&is_sparse, sizeof(is_sparse), 1, fp);
+    if(is_sparse){
+        fwrite(&(this->sparse_len), sizeof(this->sparse_len), 1, fp);
+        fwrite(this->sparse, sizeof(uint32_t), this->sparse_len, fp);
+    }
+    else
+        fwrite(this->registers, sizeof(uint8_t), this->register_count, fp);
+}
+
+/* The readers reject anything add could not have produced: sparse entries must be sorted by
+ * index with one entry per index, every index and rho in range. */
+static int HyperLogLog_read_sparse(HyperLogLog* this, FILE* fp){
+    uint32_t sparse_len;
+    if(fread(&sparse_len, sizeof(sparse_len), 1, fp) != 1 || sparse_len >= 1u << SPARSE_PRECISION)
+        return -1;
+    this->sparse_capacity = sparse_len ? sparse_len : 1;
+    this->sparse = malloc(this->sparse_capacity * sizeof(uint32_t));
+    if(!this->sparse)
+        return -1;
+    if(fread(this->sparse, sizeof(uint32_t), sparse_len, fp) != sparse_len)
+        return -1;
+    for(uint32_t i=0; i<sparse_len; i++){
+        uint32_t idx = this->sparse[i] >> SPARSE_RHO_BITS;
+        uint8_t rho = this->sparse[i] & ((1u << SPARSE_RHO_BITS) - 1);
+        if(idx >= 1u << SPARSE_PRECISION || rho == 0 || rho > 64 - SPARSE_PRECISION + 1)
+            return -1;
+        if(i > 0 && idx <= this->sparse[i - 1] >> SPARSE_RHO_BITS)
+            return -1;
+    }
+    this->sparse_len = sparse_len;
+    return 0;
+}
+
+static int HyperLogLog_read_dense(HyperLogLog* this, FILE* fp){
+    this->registers = malloc(this->register_count);
+    if(!this->registers)
+        return -1;
+    if(fread(this->registers, sizeof(uint8_t), this->register_count, fp) != this->register_count)
+        return -1;
+    for(uint32_t i=0; i<this->register_count; i++)
+        if(this->registers[i] > 64 - this->precision + 1)
+            return -1;
+    return 0;
+}
+
+HyperLogLog* HyperLogLog_deserialize(FILE* fp){
+    uint8_t precision, is_sparse;
+    if(fread(&precision, sizeof(precision), 1, fp) != 1 || fread(&is_sparse, sizeof(is_sparse), 1, fp) != 1)
+        return NULL;
+    HyperLogLog* this = HyperLogLog_new_precision(precision);
+    if(!this)
+        return NULL;
+    int status = is_sparse ? HyperLogLog_read_sparse(this, fp) : HyperLogLog_read_dense(this, fp);
+    if(status == -1){
+        HyperLogLog_destroy(this);
+        return NULL;
+    }
+    return this;
+}
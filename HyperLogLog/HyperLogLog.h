@@ -0,0 +1,35 @@
+#ifndef _MY_HYPERLOGLOG_
+#define _MY_HYPERLOGLOG_
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#define HLL_MIN_PRECISION 4
+#define HLL_MAX_PRECISION 18
+#define HLL_DEF_PRECISION 14
+
+/* Opaque types */
+typedef struct HyperLogLog HyperLogLog;
+
+/* HyperLogLog methods */
+HyperLogLog* HyperLogLog_new(void);
+HyperLogLog* HyperLogLog_new_precision(uint8_t precision);
+HyperLogLog* HyperLogLog_clone(HyperLogLog* this);
+void HyperLogLog_destroy(HyperLogLog* this);
+void HyperLogLog_clear(HyperLogLog* this);
+uint8_t HyperLogLog_precision(HyperLogLog* this);
+bool HyperLogLog_is_sparse(HyperLogLog* this);
+double HyperLogLog_standard_error(HyperLogLog* this);
+int HyperLogLog_add(HyperLogLog* this, const void* data, size_t len);
+int HyperLogLog_add_c_str(HyperLogLog* this, const char* c_str);
+int HyperLogLog_add_hash(HyperLogLog* this, uint64_t hash);
+uint64_t HyperLogLog_count(HyperLogLog* this);
+int HyperLogLog_merge(HyperLogLog* this, HyperLogLog* other);
+void HyperLogLog_serialize(HyperLogLog* this, FILE* fp);
+HyperLogLog* HyperLogLog_deserialize(FILE* fp);
+
+/* 64 bit hash used by HyperLogLog_add(...), exposed for HyperLogLog_add_hash(...) callers */
+uint64_t HyperLogLog_hash(const void* data, size_t len);
+
+#endif
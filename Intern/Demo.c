@@ -0,0 +1,19 @@
+#include <stdio.h>
+#include "Intern.h"
+
+int main(int argc, const char** argv){
+    const char* words[] = {"id", "name", "id", "tags", "name", "id"};
+    const InternStr* handles[6];
+    for(int i=0; i<6; i++)
+        handles[i] = Intern_c_str(words[i]);
+
+    printf("%u distinct strings\n", Intern_count());
+    printf("words[0] == words[2]: %d\n", handles[0] == handles[2]);
+    printf("words[0] == words[1]: %d\n", handles[0] == handles[1]);
+    printf("%s: length %u, hash %u\n", handles[3]->c_str, handles[3]->length, handles[3]->hash);
+    printf("handle from c_str: %d\n", Intern_handle(handles[1]->c_str) == handles[1]);
+
+    for(int i=0; i<6; i++)
+        Intern_release(handles[i]);
+    printf("%u distinct strings\n", Intern_count());
+}
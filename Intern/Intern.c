@@ -0,0 +1,138 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "Intern.h"
+#include "../String/StringHash.h"
+
+/* The table is guarded by pool_lock. Reference counts are atomic: a holder can retain, and
+ * release a reference that isn't the last one, without the lock. Dropping the last one takes
+ * the lock, so an entry reachable from the table always has refs >= 1 under the lock. */
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static const uint32_t FIRST_BUCKETS = 256;      /* power of 2 */
+
+/* Chained hash table of entries. The InternStr handed out sits right after its entry header. */
+typedef struct InternEntry InternEntry;
+
+struct InternEntry {
+    InternEntry* next;
+    atomic_uint refs;
+};
+
+static InternEntry** buckets;
+static uint32_t bucket_count;
+static uint32_t entry_count;
+
+static inline InternStr* entry_str(InternEntry* entry){
+    return (InternStr*)(entry + 1);
+}
+
+static inline InternEntry* str_entry(const InternStr* str){
+    return (InternEntry*)str - 1;
+}
+
+/* Same as HashTable's def_hash_function without the modulo, so tables can reuse it */
+uint32_t Intern_hash(const char* ptr, uint32_t length){
+    return string_hash_n(ptr, length);
+}
+
+static int grow(void){
+    uint32_t new_count = bucket_count ? bucket_count * 2 : FIRST_BUCKETS;
+    InternEntry** new_buckets = calloc(new_count, sizeof(InternEntry*));
+    if(!new_buckets)
+        return -1;
+    for(uint32_t i=0; i<bucket_count; i++){
+        InternEntry* entry = buckets[i];
+        while(entry != NULL){
+            InternEntry* next = entry->next;
+            InternEntry** bucket = &new_buckets[entry_str(entry)->hash & (new_count - 1)];
+            entry->next = *bucket;
+            *bucket = entry;
+            entry = next;
+        }
+    }
+    free(buckets);
+    buckets = new_buckets;
+    bucket_count = new_count;
+    return 0;
+}
+
+const InternStr* Intern_n(const char* ptr, uint32_t length){
+    return Intern_n_hashed(ptr, length, Intern_hash(ptr, length));
+}
+
+/* For callers that already have the hash of the string at hand */
+const InternStr* Intern_n_hashed(const char* ptr, uint32_t length, uint32_t hash){
+    pthread_mutex_lock(&pool_lock);
+    if(entry_count >= bucket_count && grow() == -1 && bucket_count == 0){
+        pthread_mutex_unlock(&pool_lock);
+        return NULL;
+    }
+    InternEntry** bucket = &buckets[hash & (bucket_count - 1)];
+    for(InternEntry* entry = *bucket; entry != NULL; entry = entry->next){
+        InternStr* str = entry_str(entry);
+        if(str->hash == hash && str->length == length && memcmp(str->c_str, ptr, length) == 0){
+            atomic_fetch_add_explicit(&entry->refs, 1, memory_order_relaxed);
+            pthread_mutex_unlock(&pool_lock);
+            return str;
+        }
+    }
+    InternEntry* entry = malloc(sizeof(InternEntry) + sizeof(InternStr) + length + 1);
+    if(!entry){
+        pthread_mutex_unlock(&pool_lock);
+        return NULL;
+    }
+    InternStr* str = entry_str(entry);
+    str->hash = hash;
+    str->length = length;
+    memcpy(str->c_str, ptr, length);
+    str->c_str[length] = '\0';
+    atomic_init(&entry->refs, 1);
+    entry->next = *bucket;
+    *bucket = entry;
+    entry_count++;
+    pthread_mutex_unlock(&pool_lock);
+    return str;
+}
+
+const InternStr* Intern_c_str(const char* c_str){
+    return Intern_n(c_str, strlen(c_str));
+}
+
+const InternStr* Intern_retain(const InternStr* str){
+    atomic_fetch_add_explicit(&str_entry(str)->refs, 1, memory_order_relaxed);
+    return str;
+}
+
+void Intern_release(const InternStr* str){
+    InternEntry* entry = str_entry(str);
+    unsigned int refs = atomic_load_explicit(&entry->refs, memory_order_relaxed);
+    while(refs > 1)
+        if(atomic_compare_exchange_weak_explicit(&entry->refs, &refs, refs - 1, memory_order_release, memory_order_relaxed))
+            return;
+    pthread_mutex_lock(&pool_lock);
+    if(atomic_fetch_sub_explicit(&entry->refs, 1, memory_order_acq_rel) > 1){
+        pthread_mutex_unlock(&pool_lock);   /* Intern_n handed out another reference meanwhile */
+        return;
+    }
+    InternEntry** link = &buckets[str->hash & (bucket_count - 1)];
+    while(*link != entry)
+        link = &(*link)->next;
+    *link = entry->next;
+    entry_count--;
+    pthread_mutex_unlock(&pool_lock);
+    free(entry);
+}
+
+const InternStr* Intern_handle(const char* c_str){
+    return (const InternStr*)(c_str - offsetof(InternStr, c_str));
+}
+
+uint32_t Intern_count(void){
+    pthread_mutex_lock(&pool_lock);
+    uint32_t count = entry_count;
+    pthread_mutex_unlock(&pool_lock);
+    return count;
+}
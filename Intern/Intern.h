@@ -0,0 +1,28 @@
+#ifndef _MY_INTERN_
+#define _MY_INTERN_
+#include <inttypes.h>
+
+/* Global string interning pool. Interning a byte sequence returns the one canonical, immutable
+ * copy of it, so interned strings are equal exactly when their handles are, and each distinct
+ * string is stored once however many containers hold it.
+ * Handles are reference counted: every Intern_* call that returns one takes a reference,
+ * drop it with Intern_release. The string is freed with its last reference.
+ * Thread-safe: the pool takes a mutex to add or free strings, retain and release are atomic. */
+
+typedef struct InternStr {
+    uint32_t hash;      /* HashTable's default hash, before it is reduced to the table size */
+    uint32_t length;
+    char c_str[];
+} InternStr;
+
+const InternStr* Intern_n(const char* ptr, uint32_t length);
+const InternStr* Intern_n_hashed(const char* ptr, uint32_t length, uint32_t hash);
+const InternStr* Intern_c_str(const char* c_str);
+const InternStr* Intern_retain(const InternStr* str);
+void Intern_release(const InternStr* str);
+/* The handle of an interned string, given its c_str */
+const InternStr* Intern_handle(const char* c_str);
+uint32_t Intern_hash(const char* ptr, uint32_t length);
+uint32_t Intern_count(void);
+
+#endif
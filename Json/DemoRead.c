@@ -2,7 +2,7 @@
 #include <stdlib.h>
 #include "Json.h"
 
-// gcc DemoRead.c Json.c ../List/List.c ../HT/HashTable.c
+// gcc -pthread DemoRead.c Json.c ../List/List.c ../String/String.c ../Intern/Intern.c ../HT/HashTable.c
 
 const char* json_file_path = "./DemoInput.json";
 
@@ -6,6 +6,7 @@
 #include "Json.h"
 #include "../List/List.h"
 #include "../HT/HashTable.h"
+#include "../Intern/Intern.h"
 
 struct JsonObj {
     JsonType type;
@@ -383,30 +384,48 @@ static inline void skip_empty(const char** sp){
     }
 }
 
-// input: (*sp = "abcdef\"g") -> output (abcdef"g) [malloc'd]
+// input: (*sp = "abcdef\"g") -> (abcdef"g) in *str_start, *len
 // after the call *sp points to char after string the ending "
-static char* parse_str(const char** sp){
+static int scan_str(const char** sp, const char** str_start, uint* len){
     assert(**sp == '"');
     (*sp)++;
-    const char* str_start = *sp;
+    *str_start = *sp;
+    *len = 0;
     char c, prev = 0;
-    uint len = 0;
     while((c = **sp) != 0){
         if((c == '\\') && (prev == '\\'))
             prev = 0;
         else if((c == '"') && (prev != '\\')){
-            char* ret_val = malloc(sizeof(char) * (len + 1));
-            if(!ret_val)
-                return NULL;
             (*sp)++;
-            strncpy(ret_val, str_start, len);
-            ret_val[len] = 0;
-            return ret_val;
+            return 0;
         }
-        len++;
+        (*len)++;
         (*sp)++;
     }
-    return NULL;
+    return -1;
+}
+
+// input: (*sp = "abcdef\"g") -> output (abcdef"g) [malloc'd]
+static char* parse_str(const char** sp){
+    const char* str_start;
+    uint len;
+    if(scan_str(sp, &str_start, &len) == -1)
+        return NULL;
+    char* ret_val = malloc(sizeof(char) * (len + 1));
+    if(!ret_val)
+        return NULL;
+    memcpy(ret_val, str_start, len);
+    ret_val[len] = 0;
+    return ret_val;
+}
+
+// Dictionary keys repeat a lot, so they are interned straight from the input
+static const InternStr* parse_key(const char** sp){
+    const char* str_start;
+    uint len;
+    if(scan_str(sp, &str_start, &len) == -1)
+        return NULL;
+    return Intern_n(str_start, len);
 }
 
 /* Used to read: Number, Bool, Null. 
@@ -545,20 +564,20 @@ static JsonObj* JsonObj_parse_dict(const char** sp){
     if(!jdict)
         return NULL;
     char c;
-    char* key;
+    const InternStr* key;
     while(1){
         skip_empty(sp);
         c = **sp;
         switch(c){
         case '"': {
-            key = parse_str(sp);
+            key = parse_key(sp);
             if(!key){
                 JsonObj_deep_destroy(jdict);
                 return NULL;
             }
             skip_empty(sp);
             if (**sp != ':'){
-                free(key);
+                Intern_release(key);
                 JsonObj_deep_destroy(jdict);
                 return NULL;
             }
@@ -566,12 +585,12 @@ static JsonObj* JsonObj_parse_dict(const char** sp){
             skip_empty(sp);
             JsonObj* value = parse_unknown(sp);
             if(!value){
-                free(key);
+                Intern_release(key);
                 JsonObj_deep_destroy(jdict);
                 return NULL;
             }
-            JsonObj_dict_add(jdict, key, value);
-            free(key);
+            HashTable_insert_interned(jdict->dict, key, value);
+            Intern_release(key);
             skip_empty(sp);
             if(**sp == ','){
                 (*sp)++;
@@ -8,6 +8,10 @@ char* int_to_str(int num){
     return str;
 }
 
+int cmp_desc(const void* a, const void* b){
+    return atoi(b) - atoi(a);
+}
+
 int main(int argc, const char** argv){
     List* list = List_new();
     for(unsigned int i=0; i<10; i++)
@@ -18,6 +22,20 @@ int main(int argc, const char** argv){
     while((data = ListIterator_next(&iter)) != NULL)
         printf("%s\n", (char*)data);
 
+    // drop the multiples of 4 in place
+    ListIterator_reset(&iter);
+    while((data = ListIterator_peak(&iter)) != NULL){
+        if(atoi(data) % 4 == 0)
+            free(ListIterator_remove(&iter));
+        else
+            ListIterator_next(&iter);
+    }
+    free(List_pop_back(list));
+    List_map(list, (void (*)(void* ))puts);
+
+    List_sort(list, cmp_desc);
+    List_map(list, (void (*)(void* ))puts);
+
     List_map(list, free); // free() all elems
     List_destroy(list);
 }
\ No newline at end of file
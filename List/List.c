@@ -1,27 +1,191 @@
 #include "List.h"
 #include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
 
 typedef unsigned int uint;
 
+/* The list is unrolled: every node holds up to LIST_NODE_SLOTS elements in an array,
+ * so a walk touches one node per LIST_NODE_SLOTS elements instead of one per element.
+ * Nodes are never empty. A full node is split in half on insert, and a node that drops
+ * below MERGE_THRESHOLD elements on remove takes in its successor if they fit together.
+ * Build with -DLIST_NODE_SLOTS=1 to get the plain one element per node list. */
+#ifndef LIST_NODE_SLOTS
+#define LIST_NODE_SLOTS 16
+#endif
+
+#define MERGE_THRESHOLD (LIST_NODE_SLOTS / 2)
+
 struct ListNode {
-    void* data;
+    ListNode* prev;
     ListNode* next;
+    uint count;
+    void* data[LIST_NODE_SLOTS];
+};
+
+/* Nodes come from slabs, which start small and double in size so that short lists
+ * stay cheap. Freed nodes are kept on a free list threaded through their next
+ * pointers, and go back to the system only when the whole pool is released. */
+#define FIRST_SLAB_NODES 2
+#define MAX_SLAB_NODES 256
+
+typedef struct ListSlab ListSlab;
+
+struct ListSlab {
+    ListSlab* next;
+    ListNode nodes[];
+};
+
+struct ListPool {
+    ListSlab* slabs;
+    ListSlab* last_slab;
+    ListNode* free_nodes;
+    ListNode* last_free_node;
+    uint slab_nodes;
 };
 
 struct List {
     ListNode* head;
     ListNode* tail;
     uint length;
+    ListPool* pool;         /* &own_pool, or a pool shared with other lists */
+    ListPool own_pool;
 };
 
 
+static void ListPool_init(ListPool* this){
+    this->slabs = NULL;
+    this->last_slab = NULL;
+    this->free_nodes = NULL;
+    this->last_free_node = NULL;
+    this->slab_nodes = FIRST_SLAB_NODES;
+}
+
+static void ListPool_release(ListPool* this){
+    ListSlab* slab = this->slabs;
+    while(slab != NULL){
+        ListSlab* next = slab->next;
+        free(slab);
+        slab = next;
+    }
+    ListPool_init(this);
+}
+
+static int ListPool_grow(ListPool* this){
+    uint count = this->slab_nodes;
+    ListSlab* slab = malloc(sizeof(ListSlab) + count * sizeof(ListNode));
+    if(!slab)
+        return -1;
+    if(this->slabs == NULL)
+        this->last_slab = slab;
+    slab->next = this->slabs;
+    this->slabs = slab;
+    if(this->free_nodes == NULL)
+        this->last_free_node = &slab->nodes[0];
+    for(uint i=0; i<count; i++){
+        slab->nodes[i].next = this->free_nodes;
+        this->free_nodes = &slab->nodes[i];
+    }
+    if(this->slab_nodes < MAX_SLAB_NODES)
+        this->slab_nodes *= 2;
+    return 0;
+}
+
+ListPool* ListPool_new(void){
+    ListPool* this = malloc(sizeof(ListPool));
+    if(!this)
+        return NULL;
+    ListPool_init(this);
+    return this;
+}
+
+/* Every list using the pool must have been destroyed first */
+void ListPool_destroy(ListPool* this){
+    ListPool_release(this);
+    free(this);
+}
+
+/* Moves all slabs and free nodes of other into this, other is left empty */
+static void ListPool_absorb(ListPool* this, ListPool* other){
+    if(other->slabs == NULL)
+        return;
+    if(this->slabs == NULL)
+        this->last_slab = other->last_slab;
+    other->last_slab->next = this->slabs;
+    this->slabs = other->slabs;
+    if(other->free_nodes){
+        if(this->free_nodes == NULL)
+            this->last_free_node = other->last_free_node;
+        other->last_free_node->next = this->free_nodes;
+        this->free_nodes = other->free_nodes;
+    }
+    if(other->slab_nodes > this->slab_nodes)
+        this->slab_nodes = other->slab_nodes;
+    ListPool_init(other);
+}
+
+static ListNode* ListNode_new(List* this){
+    ListPool* pool = this->pool;
+    if(pool->free_nodes == NULL && ListPool_grow(pool) == -1)
+        return NULL;
+    ListNode* node = pool->free_nodes;
+    pool->free_nodes = node->next;
+    node->prev = NULL;
+    node->next = NULL;
+    node->count = 0;
+    return node;
+}
+
+static void ListNode_free(List* this, ListNode* node){
+    ListPool* pool = this->pool;
+    if(pool->free_nodes == NULL)
+        pool->last_free_node = node;
+    node->next = pool->free_nodes;
+    pool->free_nodes = node;
+}
+
+/* Links node into the list right after prev, or at the head if prev is NULL */
+static void List_link_node(List* this, ListNode* prev, ListNode* node){
+    ListNode* next = prev ? prev->next : this->head;
+    node->prev = prev;
+    node->next = next;
+    if(prev)
+        prev->next = node;
+    else
+        this->head = node;
+    if(next)
+        next->prev = node;
+    else
+        this->tail = node;
+}
+
+static void List_unlink_node(List* this, ListNode* node){
+    if(node->prev)
+        node->prev->next = node->next;
+    else
+        this->head = node->next;
+    if(node->next)
+        node->next->prev = node->prev;
+    else
+        this->tail = node->prev;
+    ListNode_free(this, node);
+}
+
 List* List_new(void){
+    return List_new_pooled(NULL);
+}
+
+/* The list takes its nodes from pool. A pool may be shared by any number of lists of one thread.
+ * With a NULL pool the list gets a private one, which List_clear releases in whole slabs. */
+List* List_new_pooled(ListPool* pool){
     List* this = malloc(sizeof(List));
     if(!this)
         return NULL;
     this->head = NULL;
     this->tail = NULL;
     this->length = 0;
+    ListPool_init(&this->own_pool);
+    this->pool = pool ? pool : &this->own_pool;
     return this;
 }
 
@@ -40,149 +204,489 @@ uint List_length(List* this){
 }
 
 void List_clear(List* this){
-    ListNode* prev = this->head;
-    if(prev == NULL)
-        return;
-    ListNode* node = prev->next;
-    while(node != NULL){
-        free(prev);
-        prev = node;
-        node = node->next;
+    if(this->pool == &this->own_pool)
+        ListPool_release(this->pool);
+    else {
+        ListNode* node = this->head;
+        while(node != NULL){
+            ListNode* next = node->next;
+            ListNode_free(this, node);
+            node = next;
+        }
     }
-    free(prev);
     this->length = 0;
     this->head = NULL;
     this->tail = NULL;
 }
 
 int List_push_front(List* this, const void* data){
-    ListNode* node = malloc(sizeof(ListNode));
-    if(!node)
-        return -1;
-    node->data = (void*)data;
-    node->next = this->head;
-    this->head = node;
-    if(this->tail == NULL)
-        this->tail = node;
+    ListNode* node = this->head;
+    if(node == NULL || node->count == LIST_NODE_SLOTS){
+        node = ListNode_new(this);
+        if(!node)
+            return -1;
+        List_link_node(this, NULL, node);
+    }
+    memmove(&node->data[1], &node->data[0], node->count * sizeof(void*));
+    node->data[0] = (void*)data;
+    node->count++;
     this->length++;
     return 0;
 }
 
 int List_append(List* this, const void* data){
-    ListNode* node = malloc(sizeof(ListNode));
-    if(!node)
-        return -1;
-    node->data = (void*)data;
-    node->next = NULL;
-    if(this->length == 0){
-        this->head = node;
-        this->tail = node;
+    ListNode* node = this->tail;
+    if(node == NULL || node->count == LIST_NODE_SLOTS){
+        node = ListNode_new(this);
+        if(!node)
+            return -1;
+        List_link_node(this, this->tail, node);
+    }
+    node->data[node->count++] = (void*)data;
+    this->length++;
+    return 0;
+}
+
+/* Returns the node holding element index, and its slot in *slot. index must be < length.
+ * Walks from whichever end is closer. */
+static ListNode* List_find_node(List* this, uint index, uint* slot){
+    ListNode* node;
+    if(index < this->length / 2){
+        node = this->head;
+        while(index >= node->count){
+            index -= node->count;
+            node = node->next;
+        }
     }
     else {
-        this->tail->next = node;
-        this->tail = node;
+        uint rest = this->length - index;   /* elements from index to the end */
+        node = this->tail;
+        while(rest > node->count){
+            rest -= node->count;
+            node = node->prev;
+        }
+        index = node->count - rest;
+    }
+    *slot = index;
+    return node;
+}
+
+/* Inserts data at *slot of *node, slot may be node->count. A full node is split first,
+ * or followed by a new node when data goes after its last element.
+ * On return *node and *slot tell where data went. */
+static int List_insert_at(List* this, ListNode** node_ptr, uint* slot_ptr, const void* data){
+    ListNode* node = *node_ptr;
+    uint slot = *slot_ptr;
+    if(node->count == LIST_NODE_SLOTS){
+        ListNode* new = ListNode_new(this);
+        if(!new)
+            return -1;
+        uint move = slot == node->count ? 0 : (node->count + 1) / 2;
+        node->count -= move;
+        memcpy(new->data, &node->data[node->count], move * sizeof(void*));
+        new->count = move;
+        List_link_node(this, node, new);
+        if(slot > node->count || move == 0){
+            slot -= node->count;
+            node = new;
+        }
     }
+    memmove(&node->data[slot + 1], &node->data[slot], (node->count - slot) * sizeof(void*));
+    node->data[slot] = (void*)data;
+    node->count++;
     this->length++;
+    *node_ptr = node;
+    *slot_ptr = slot;
     return 0;
 }
 
+/* Removes the element at *slot of *node. A node left empty is freed, and one that drops
+ * below MERGE_THRESHOLD takes in its successor if they fit together.
+ * On return *node and *slot tell where the element that followed it is now (NULL at the end). */
+static void* List_remove_at(List* this, ListNode** node_ptr, uint* slot_ptr){
+    ListNode* node = *node_ptr;
+    uint slot = *slot_ptr;
+    void* ret_val = node->data[slot];
+    node->count--;
+    memmove(&node->data[slot], &node->data[slot + 1], (node->count - slot) * sizeof(void*));
+    this->length--;
+
+    ListNode* next = node->next;
+    if(node->count == 0){
+        List_unlink_node(this, node);
+        *node_ptr = next;
+        *slot_ptr = 0;
+        return ret_val;
+    }
+    if(node->count < MERGE_THRESHOLD && next && node->count + next->count <= LIST_NODE_SLOTS){
+        memcpy(&node->data[node->count], next->data, next->count * sizeof(void*));
+        node->count += next->count;
+        List_unlink_node(this, next);
+    }
+    if(node->count == slot){
+        *node_ptr = node->next;
+        *slot_ptr = 0;
+    }
+    else
+        *node_ptr = node;
+    return ret_val;
+}
+
 int List_insert(List* this, const void* data, uint index){
     if(index == 0)
         return List_push_front(this, data);
     if(index >= this->length)
         return List_append(this, data);
-
-    ListNode* new = malloc(sizeof(ListNode));
-    if(!new)
-        return -1;
-    new->data = (void*)data;
-    ListNode* prev;
-    ListNode* node = this->head;
-    uint i = 0;
-    while(i++ < index){
-        prev = node;
-        node = node->next;
-    }
-    prev->next = new;
-    new->next = node;
-    this->length++;
-    return 0;
+    uint slot;
+    ListNode* node = List_find_node(this, index, &slot);
+    return List_insert_at(this, &node, &slot, data);
 }
 
 void* List_get(List* this, unsigned int index){
     if(index >= this->length)
         return NULL;
-    if(index + 1 == this->length)
-        return this->tail->data;
-    ListNode* node = this->head;
-    unsigned int i = 0;
-    while(i++ < index)
-        node = node->next;
-    return node->data;
+    uint slot;
+    ListNode* node = List_find_node(this, index, &slot);
+    return node->data[slot];
 }
 
 void* List_remove(List* this, unsigned int index){
-    void* ret_val;
     if(index >= this->length)
         return NULL;
-        
-    ListNode* prev = this->head;
-    ListNode* node = prev->next;
-    if(index == 0){
-        this->head = this->head->next;
-        if(this->length == 1)
-            this->tail = NULL;
-        ret_val = prev->data;
-        free(prev);
-        this->length--;
-        return ret_val;
+    uint slot;
+    ListNode* node = List_find_node(this, index, &slot);
+    return List_remove_at(this, &node, &slot);
+}
+
+void* List_pop_back(List* this){
+    if(this->length == 0)
+        return NULL;
+    ListNode* node = this->tail;
+    uint slot = node->count - 1;
+    return List_remove_at(this, &node, &slot);
+}
+
+/* Copies the nodes of other into nodes of this pool and links them at the end of this */
+static int List_copy_nodes(List* this, List* other){
+    ListNode* first = NULL;
+    ListNode* last = NULL;
+    for(ListNode* node = other->head; node != NULL; node = node->next){
+        ListNode* copy = ListNode_new(this);
+        if(!copy){
+            while(first != NULL){
+                ListNode* next = first->next;
+                ListNode_free(this, first);
+                first = next;
+            }
+            return -1;
+        }
+        memcpy(copy->data, node->data, node->count * sizeof(void*));
+        copy->count = node->count;
+        copy->prev = last;
+        if(last)
+            last->next = copy;
+        else
+            first = copy;
+        last = copy;
+    }
+    first->prev = this->tail;
+    if(this->tail)
+        this->tail->next = first;
+    else
+        this->head = first;
+    this->tail = last;
+    return 0;
+}
+
+/* Moves every element of other to the end of this, other is left empty.
+ * O(1) when both lists have private pools or share one, otherwise the nodes are copied. */
+int List_concat(List* this, List* other){
+    if(this == other || other->length == 0)
+        return 0;
+    bool own_pools = this->pool == &this->own_pool && other->pool == &other->own_pool;
+    if(own_pools || this->pool == other->pool){
+        if(own_pools)
+            ListPool_absorb(this->pool, other->pool);
+        other->head->prev = this->tail;
+        if(this->tail)
+            this->tail->next = other->head;
+        else
+            this->head = other->head;
+        this->tail = other->tail;
+        this->length += other->length;
+        other->head = NULL;
+        other->tail = NULL;
+        other->length = 0;
+        return 0;
+    }
+    if(List_copy_nodes(this, other) == -1)
+        return -1;
+    this->length += other->length;
+    List_clear(other);
+    return 0;
+}
+
+/* List_sort and List_merge_sorted move the element pointers between the nodes of the list
+ * instead of relinking one node per element. A merge writes its output into nodes that its
+ * inputs have already been fully read from, plus at most two spare nodes, which are taken
+ * up front so that the sort can't fail halfway. Runs are NULL terminated chains of nodes
+ * whose prev links are fixed at the end.
+ * Merged output is packed into full nodes, but runs that are already in order are just
+ * linked, keeping their nodes as they were: the sort does not compact the list. */
+#define SORT_SPARE_NODES 2
+
+typedef int (*cmp_fn)(const void* , const void* );
+
+typedef struct NodeRun {
+    ListNode* head;
+    ListNode* tail;
+} NodeRun;
+
+static int List_take_spares(List* this, ListNode** spares){
+    *spares = NULL;
+    for(uint i=0; i<SORT_SPARE_NODES; i++){
+        ListNode* node = ListNode_new(this);
+        if(!node){
+            while(*spares != NULL){
+                ListNode* next = (*spares)->next;
+                ListNode_free(this, *spares);
+                *spares = next;
+            }
+            return -1;
+        }
+        node->next = *spares;
+        *spares = node;
     }
-    uint i = 1;
-    while(i++ < index){
+    return 0;
+}
+
+static void List_return_spares(List* this, ListNode* spares){
+    while(spares != NULL){
+        ListNode* next = spares->next;
+        ListNode_free(this, spares);
+        spares = next;
+    }
+}
+
+/* Makes run the node chain of the list, fixing the prev links and the tail */
+static void List_relink(List* this, NodeRun run){
+    ListNode* prev = NULL;
+    for(ListNode* node = run.head; node != NULL; node = node->next){
+        node->prev = prev;
         prev = node;
-        node = node->next;
     }
-    prev->next = node->next;
-    if(index + 1 == this->length)
-        this->tail = prev;
-    ret_val = node->data;
-    free(node);
-    this->length--;
-    return ret_val;
+    this->head = run.head;
+    this->tail = run.tail;
+}
+
+/* Stable insertion sort of the slots of one node */
+static void sort_node(ListNode* node, cmp_fn cmp){
+    for(uint i=1; i<node->count; i++){
+        void* item = node->data[i];
+        uint j = i;
+        while(j > 0 && cmp(item, node->data[j - 1]) < 0){
+            node->data[j] = node->data[j - 1];
+            j--;
+        }
+        node->data[j] = item;
+    }
+}
+
+/* Merges run a with run b, which follows it. On equal items a goes first. */
+static NodeRun merge_runs(NodeRun a, NodeRun b, cmp_fn cmp, ListNode** spares){
+    /* already in order: O(1), partially filled nodes stay that way */
+    if(cmp(b.head->data[0], a.tail->data[a.tail->count - 1]) >= 0){
+        a.tail->next = b.head;
+        return (NodeRun) { a.head, b.tail };
+    }
+    NodeRun out = { NULL, NULL };
+    ListNode* in_a = a.head;
+    ListNode* in_b = b.head;
+    uint slot_a = 0, slot_b = 0;
+    while(in_a || in_b){
+        void* item;
+        if(in_a && (!in_b || cmp(in_b->data[slot_b], in_a->data[slot_a]) >= 0)){
+            item = in_a->data[slot_a++];
+            if(slot_a == in_a->count){
+                ListNode* next = in_a->next;
+                in_a->next = *spares;
+                *spares = in_a;
+                in_a = next;
+                slot_a = 0;
+            }
+        }
+        else {
+            item = in_b->data[slot_b++];
+            if(slot_b == in_b->count){
+                ListNode* next = in_b->next;
+                in_b->next = *spares;
+                *spares = in_b;
+                in_b = next;
+                slot_b = 0;
+            }
+        }
+        if(out.tail == NULL || out.tail->count == LIST_NODE_SLOTS){
+            ListNode* node = *spares;
+            *spares = node->next;
+            node->next = NULL;
+            node->count = 0;
+            if(out.tail)
+                out.tail->next = node;
+            else
+                out.head = node;
+            out.tail = node;
+        }
+        out.tail->data[out.tail->count++] = item;
+    }
+    return out;
+}
+
+/* Stable bottom-up merge sort. cmp receives the items themselves.
+ * Returns -1, leaving the list as it was, only if the spare nodes can't be allocated. */
+int List_sort(List* this, int (*cmp)(const void* , const void* )){
+    if(this->head == this->tail){
+        if(this->head)
+            sort_node(this->head, cmp);
+        return 0;
+    }
+    ListNode* spares;
+    if(List_take_spares(this, &spares) == -1)
+        return -1;
+
+    /* levels[i] is empty or a sorted run of 2^i input nodes, higher levels hold earlier items */
+    NodeRun levels[64] = {{ NULL, NULL }};
+    ListNode* node = this->head;
+    while(node != NULL){
+        ListNode* next = node->next;
+        node->next = NULL;
+        sort_node(node, cmp);
+        NodeRun run = { node, node };
+        uint level = 0;
+        for(; levels[level].head != NULL; level++){
+            run = merge_runs(levels[level], run, cmp, &spares);
+            levels[level].head = NULL;
+        }
+        levels[level] = run;
+        node = next;
+    }
+    NodeRun run = { NULL, NULL };
+    for(uint level=0; level<64; level++){
+        if(levels[level].head == NULL)
+            continue;
+        run = run.head ? merge_runs(levels[level], run, cmp, &spares) : levels[level];
+    }
+    List_relink(this, run);
+    List_return_spares(this, spares);
+    return 0;
+}
+
+/* Merges other, which must be sorted like this, into this. other is left empty.
+ * Stable: of equal items, those of this go first. */
+int List_merge_sorted(List* this, List* other, int (*cmp)(const void* , const void* )){
+    if(this == other || other->length == 0)
+        return 0;
+    if(this->length == 0)
+        return List_concat(this, other);
+    ListNode* spares;
+    if(List_take_spares(this, &spares) == -1)
+        return -1;
+    ListNode* last = this->tail;
+    if(List_concat(this, other) == -1){
+        List_return_spares(this, spares);
+        return -1;
+    }
+    NodeRun a = { this->head, last };
+    NodeRun b = { last->next, this->tail };
+    last->next = NULL;
+    List_relink(this, merge_runs(a, b, cmp, &spares));
+    List_return_spares(this, spares);
+    return 0;
 }
 
 void List_map(List* this, void (*func)(void* )){
-    ListIterator iter = ListIterator_new(this);
-    void* list_item;
-    while((list_item = ListIterator_next(&iter)) != NULL)
-        func(list_item);
+    for(ListNode* node = this->head; node != NULL; node = node->next)
+        for(uint i=0; i<node->count; i++)
+            func(node->data[i]);
 }
 
 ListIterator ListIterator_new(List* list){
     return (ListIterator) {
         .list = list,
-        .current_node = list->head
+        .current_node = list->head,
+        .slot = 0
     };
 }
 
 int ListIterator_has_next(ListIterator* this){
-    return (this->current_node) && (this->current_node->next);
+    return (this->current_node) && (this->slot + 1 < this->current_node->count || this->current_node->next);
 }
 
 void* ListIterator_next(ListIterator* this){
     if(this->current_node == NULL)
         return NULL;
-    void* ret_val = this->current_node->data;
-    this->current_node = this->current_node->next;
+    void* ret_val = this->current_node->data[this->slot++];
+    if(this->slot == this->current_node->count){
+        this->current_node = this->current_node->next;
+        this->slot = 0;
+    }
     return ret_val;
 }
 
 void* ListIterator_peak(ListIterator* this){
     if(this->current_node == NULL)
         return NULL;
-    return this->current_node->data;
+    return this->current_node->data[this->slot];
 }
 
 void ListIterator_reset(ListIterator* this){
     this->current_node = this->list->head;
-}
\ No newline at end of file
+    this->slot = 0;
+}
+
+/* Removes the current element and returns it, the iterator moves on to the next one.
+ * Other iterators of the list are invalidated. */
+void* ListIterator_remove(ListIterator* this){
+    if(this->current_node == NULL)
+        return NULL;
+    return List_remove_at(this->list, &this->current_node, &this->slot);
+}
+
+/* Inserts data before the current element (at the end if there is none).
+ * The iterator stays on the current element. */
+int ListIterator_insert_before(ListIterator* this, const void* data){
+    if(this->current_node == NULL)
+        return List_append(this->list, data);
+    ListNode* node = this->current_node;
+    uint slot = this->slot;
+    if(List_insert_at(this->list, &node, &slot, data) == -1)
+        return -1;
+    if(slot + 1 < node->count){
+        this->current_node = node;
+        this->slot = slot + 1;
+    }
+    else {
+        this->current_node = node->next;
+        this->slot = 0;
+    }
+    return 0;
+}
+
+/* Inserts data after the current element, so that next() returns the current element and
+ * then data. Returns -1 if there is no current element. */
+int ListIterator_insert_after(ListIterator* this, const void* data){
+    if(this->current_node == NULL)
+        return -1;
+    ListNode* node = this->current_node;
+    uint slot = this->slot + 1;
+    if(List_insert_at(this->list, &node, &slot, data) == -1)
+        return -1;
+    if(slot > 0){
+        this->current_node = node;
+        this->slot = slot - 1;
+    }
+    else {
+        this->current_node = node->prev;
+        this->slot = node->prev->count - 1;
+    }
+    return 0;
+}
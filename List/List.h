@@ -4,15 +4,18 @@
 /* Opaque types */
 typedef struct List List;
 typedef struct ListNode ListNode;
+typedef struct ListPool ListPool;
 
 /* Types */
 typedef struct ListIterator {
     List* list;
     ListNode* current_node;
+    unsigned int slot;      /* index of the current element inside current_node */
 } ListIterator;
 
 /* List methods */
 List* List_new(void);
+List* List_new_pooled(ListPool* pool);
 void List_destroy(List* this);
 void List_clear(List* this);
 unsigned int List_length(List* this);
@@ -21,13 +24,24 @@ int List_append(List* this, const void* data);
 int List_insert(List* this, const void* data, unsigned int index);
 void* List_get(List* this, unsigned int index);
 void* List_remove(List* this, unsigned int index);
+void* List_pop_back(List* this);
+int List_concat(List* this, List* other);
+int List_sort(List* this, int (*cmp)(const void* , const void* ));
+int List_merge_sorted(List* this, List* other, int (*cmp)(const void* , const void* ));
 void List_map(List* this, void (*func)(void* ));
 
+/* ListPool methods */
+ListPool* ListPool_new(void);
+void ListPool_destroy(ListPool* this);
+
 /* ListIterator methods */
 ListIterator ListIterator_new(List* list);
 int ListIterator_has_next(ListIterator* this);
 void* ListIterator_next(ListIterator* this);
 void* ListIterator_peak(ListIterator* this);
 void ListIterator_reset(ListIterator* this);
+void* ListIterator_remove(ListIterator* this);
+int ListIterator_insert_before(ListIterator* this, const void* data);
+int ListIterator_insert_after(ListIterator* this, const void* data);
 
 #endif
@@ -0,0 +1,63 @@
+#include "Queue.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define PRODUCERS 4
+#define CONSUMERS 2
+#define JOBS_PER_PRODUCER 100000
+
+static MPSCQueue* results;
+static MPMCQueue* jobs;
+static atomic_int producers_left = PRODUCERS;
+
+// producers post jobs (numbers to square) for any worker to pick up
+void* produce(void* arg) {
+    uintptr_t first = (uintptr_t)arg * JOBS_PER_PRODUCER;
+    for (uintptr_t i = 1; i <= JOBS_PER_PRODUCER; i++)
+        MPMCQueue_push(jobs, (void*)(first + i));
+    atomic_fetch_sub(&producers_left, 1);
+    return NULL;
+}
+
+// workers take jobs until the producers are done and the queue is drained,
+// and report every result to the single collector
+void* work(void* arg) {
+    void* job;
+    while (true) {
+        if (MPMCQueue_pop(jobs, &job) == 0)
+            MPSCQueue_push(results, (void*)((uintptr_t)job % 1000 * ((uintptr_t)job % 1000)));
+        else if (atomic_load(&producers_left) == 0 && MPMCQueue_is_empty(jobs))
+            break;
+    }
+    return NULL;
+}
+
+int main(int argc, const char* argv[]) {
+    results = MPSCQueue_new();
+    jobs = MPMCQueue_new();
+    pthread_t producers[PRODUCERS], workers[CONSUMERS];
+    for (uintptr_t i = 0; i < PRODUCERS; i++)
+        pthread_create(&producers[i], NULL, produce, (void*)i);
+    for (int i = 0; i < CONSUMERS; i++)
+        pthread_create(&workers[i], NULL, work, NULL);
+
+    uint64_t collected = 0, total = 0;
+    void* result;
+    while (collected < (uint64_t)PRODUCERS * JOBS_PER_PRODUCER) {
+        if (MPSCQueue_pop(results, &result) == 0) {
+            total += (uintptr_t)result;
+            collected++;
+        }
+    }
+    for (int i = 0; i < PRODUCERS; i++)
+        pthread_join(producers[i], NULL);
+    for (int i = 0; i < CONSUMERS; i++)
+        pthread_join(workers[i], NULL);
+    printf("collected %lu results, sum %lu\n", collected, total);
+
+    MPMCQueue_destroy(jobs);
+    MPSCQueue_destroy(results);
+    return 0;
+}
@@ -0,0 +1,279 @@
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "Queue.h"
+#include "../Epoch/Epoch.h"
+
+/* Both queues are linked lists of QNodes that start with a dummy node: the node at the
+ * consumer end has already been consumed, and its successor holds the next value. */
+
+typedef struct QNode QNode;
+
+struct QNode {
+    _Atomic(QNode*) next;
+    void* value;
+};
+
+/* Node pool, shared by every queue. Each thread keeps a private free list, so pushing and
+ * popping nodes needs no synchronization. A thread that frees more than it allocates (the
+ * consumer) hands whole batches of BATCH_NODES to a shared depot, and a thread that runs out
+ * (a producer) takes a batch back from it, so the depot lock is taken once per batch.
+ * The depot keeps at most DEPOT_MAX_BATCHES batches and frees the nodes of any beyond that,
+ * so a burst doesn't hold its peak number of nodes for the rest of the process. */
+#define BATCH_NODES 64
+#define DEPOT_MAX_BATCHES 64
+
+static _Thread_local QNode* local_nodes;
+static _Thread_local uint32_t local_count;
+static _Thread_local bool flush_registered;
+
+static pthread_mutex_t depot_lock = PTHREAD_MUTEX_INITIALIZER;
+static QNode* depot;    /* batches, chained through the value of their first node */
+static uint32_t depot_batches;
+
+static pthread_key_t flush_key;
+static pthread_once_t flush_key_once = PTHREAD_ONCE_INIT;
+
+static void free_batch(QNode* batch){
+    while(batch != NULL){
+        QNode* next = atomic_load_explicit(&batch->next, memory_order_relaxed);
+        free(batch);
+        batch = next;
+    }
+}
+
+static void depot_push(QNode* batch){
+    pthread_mutex_lock(&depot_lock);
+    bool full = depot_batches == DEPOT_MAX_BATCHES;
+    if(!full){
+        batch->value = depot;
+        depot = batch;
+        depot_batches++;
+    }
+    pthread_mutex_unlock(&depot_lock);
+    if(full)
+        free_batch(batch);
+}
+
+static QNode* depot_pop(void){
+    pthread_mutex_lock(&depot_lock);
+    QNode* batch = depot;
+    if(batch){
+        depot = batch->value;
+        depot_batches--;
+    }
+    pthread_mutex_unlock(&depot_lock);
+    return batch;
+}
+
+/* On thread exit the private nodes go to the depot, as one possibly short batch */
+static void flush_local_nodes(void* unused){
+    (void)unused;
+    if(local_nodes)
+        depot_push(local_nodes);
+    local_nodes = NULL;
+    local_count = 0;
+    flush_registered = false;   /* nodes freed by later destructors register again */
+}
+
+static void create_flush_key(void){
+    pthread_key_create(&flush_key, flush_local_nodes);
+}
+
+static void register_flush(void){
+    pthread_once(&flush_key_once, create_flush_key);
+    pthread_setspecific(flush_key, &flush_key);
+    flush_registered = true;
+}
+
+static QNode* QNode_new(const void* value){
+    QNode* node = local_nodes;
+    if(node == NULL){
+        if(!flush_registered)
+            register_flush();
+        node = depot_pop();
+        if(node){
+            local_count = 0;
+            for(QNode* n = node; n != NULL; n = atomic_load_explicit(&n->next, memory_order_relaxed))
+                local_count++;
+        }
+        else if(!(node = malloc(sizeof(QNode))))
+            return NULL;
+        else {
+            atomic_init(&node->next, NULL);
+            local_count = 1;
+        }
+    }
+    local_nodes = atomic_load_explicit(&node->next, memory_order_relaxed);
+    local_count--;
+    atomic_store_explicit(&node->next, NULL, memory_order_relaxed);
+    node->value = (void*)value;
+    return node;
+}
+
+static void QNode_free(void* ptr){
+    QNode* node = ptr;
+    if(!flush_registered)
+        register_flush();
+    atomic_store_explicit(&node->next, local_nodes, memory_order_relaxed);
+    local_nodes = node;
+    if(++local_count < 2 * BATCH_NODES)
+        return;
+    /* keep BATCH_NODES, hand the rest over */
+    QNode* last = node;
+    for(uint32_t i=1; i<BATCH_NODES; i++)
+        last = atomic_load_explicit(&last->next, memory_order_relaxed);
+    QNode* batch = atomic_load_explicit(&last->next, memory_order_relaxed);
+    atomic_store_explicit(&last->next, NULL, memory_order_relaxed);
+    local_count = BATCH_NODES;
+    depot_push(batch);
+}
+
+
+struct MPSCQueue {
+    _Alignas(64) QNode* head;           /* dummy node, only the consumer touches it */
+    _Alignas(64) _Atomic(QNode*) tail;  /* last pushed node, producers swap themselves in here */
+};
+
+MPSCQueue* MPSCQueue_new(void){
+    MPSCQueue* this = aligned_alloc(_Alignof(MPSCQueue), sizeof(MPSCQueue));
+    if(!this)
+        return NULL;
+    QNode* dummy = QNode_new(NULL);
+    if(!dummy){
+        free(this);
+        return NULL;
+    }
+    atomic_init(&this->tail, dummy);
+    this->head = dummy;
+    return this;
+}
+
+void MPSCQueue_destroy(MPSCQueue* this){
+    QNode* node = this->head;
+    while(node != NULL){
+        QNode* next = atomic_load_explicit(&node->next, memory_order_relaxed);
+        QNode_free(node);
+        node = next;
+    }
+    free(this);
+}
+
+int MPSCQueue_push(MPSCQueue* this, const void* value){
+    QNode* node = QNode_new(value);
+    if(!node)
+        return -1;
+    QNode* prev = atomic_exchange_explicit(&this->tail, node, memory_order_acq_rel);
+    /* until this store the consumer can't see node, nor anything pushed after it */
+    atomic_store_explicit(&prev->next, node, memory_order_release);
+    return 0;
+}
+
+/* Returns -1 if the queue is empty */
+int MPSCQueue_pop(MPSCQueue* this, void** value_out){
+    QNode* head = this->head;
+    QNode* next = atomic_load_explicit(&head->next, memory_order_acquire);
+    if(next == NULL)
+        return -1;
+    *value_out = next->value;
+    this->head = next;
+    /* no producer can still be on head: the one that linked next was the last to touch it */
+    QNode_free(head);
+    return 0;
+}
+
+bool MPSCQueue_is_empty(MPSCQueue* this){
+    return atomic_load_explicit(&this->head->next, memory_order_acquire) == NULL;
+}
+
+
+struct MPMCQueue {
+    _Alignas(64) _Atomic(QNode*) head;  /* dummy node */
+    _Alignas(64) _Atomic(QNode*) tail;  /* last node, or lagging one behind it */
+};
+
+MPMCQueue* MPMCQueue_new(void){
+    MPMCQueue* this = aligned_alloc(_Alignof(MPMCQueue), sizeof(MPMCQueue));
+    if(!this)
+        return NULL;
+    QNode* dummy = QNode_new(NULL);
+    if(!dummy){
+        free(this);
+        return NULL;
+    }
+    atomic_init(&this->head, dummy);
+    atomic_init(&this->tail, dummy);
+    return this;
+}
+
+void MPMCQueue_destroy(MPMCQueue* this){
+    QNode* node = atomic_load(&this->head);
+    while(node != NULL){
+        QNode* next = atomic_load_explicit(&node->next, memory_order_relaxed);
+        QNode_free(node);
+        node = next;
+    }
+    free(this);
+}
+
+int MPMCQueue_push(MPMCQueue* this, const void* value){
+    QNode* node = QNode_new(value);
+    if(!node)
+        return -1;
+    Epoch_enter();
+    QNode* tail;
+    while(true){
+        tail = atomic_load(&this->tail);
+        QNode* next = atomic_load(&tail->next);
+        if(tail != atomic_load(&this->tail))
+            continue;
+        if(next != NULL){
+            atomic_compare_exchange_weak(&this->tail, &tail, next);  /* help the lagging push */
+            continue;
+        }
+        if(atomic_compare_exchange_weak(&tail->next, &next, node))
+            break;
+    }
+    atomic_compare_exchange_strong(&this->tail, &tail, node);
+    Epoch_exit();
+    return 0;
+}
+
+/* Returns -1 if the queue is empty */
+int MPMCQueue_pop(MPMCQueue* this, void** value_out){
+    Epoch_enter();
+    QNode* head;
+    while(true){
+        head = atomic_load(&this->head);
+        QNode* tail = atomic_load(&this->tail);
+        QNode* next = atomic_load(&head->next);
+        if(head != atomic_load(&this->head))
+            continue;
+        if(next == NULL){
+            Epoch_exit();
+            return -1;
+        }
+        if(head == tail){
+            atomic_compare_exchange_weak(&this->tail, &tail, next);
+            continue;
+        }
+        void* value = next->value;
+        if(atomic_compare_exchange_weak(&this->head, &head, next)){
+            *value_out = value;
+            break;
+        }
+    }
+    Epoch_exit();
+    /* other consumers may still be reading head, and it must not come back as a new node
+     * while they hold it (ABA), so it goes back to the pool only once they are done */
+    Epoch_retire(head, QNode_free);
+    return 0;
+}
+
+bool MPMCQueue_is_empty(MPMCQueue* this){
+    Epoch_enter();
+    bool empty = atomic_load(&atomic_load(&this->head)->next) == NULL;
+    Epoch_exit();
+    return empty;
+}
@@ -0,0 +1,30 @@
+#ifndef _MY_QUEUE_
+#define _MY_QUEUE_
+#include <stdbool.h>
+
+/* Opaque types */
+typedef struct MPSCQueue MPSCQueue;
+typedef struct MPMCQueue MPMCQueue;
+
+/* MPSCQueue methods
+ * Unbounded FIFO for any number of producers and one consumer (Vyukov). push is wait-free.
+ * pop must only be called by one thread at a time, and it may miss an element whose push
+ * has not finished yet, along with the ones pushed after it (they show up on a later pop).
+ * Values are not owned, NULL is a valid value. destroy needs the queue to be quiescent. */
+MPSCQueue* MPSCQueue_new(void);
+void MPSCQueue_destroy(MPSCQueue* this);
+int MPSCQueue_push(MPSCQueue* this, const void* value);
+int MPSCQueue_pop(MPSCQueue* this, void** value_out);
+bool MPSCQueue_is_empty(MPSCQueue* this);
+
+/* MPMCQueue methods
+ * Unbounded lock-free FIFO for any number of producers and consumers (Michael-Scott).
+ * Dequeued nodes are reclaimed through ../Epoch.
+ * Values are not owned, NULL is a valid value. destroy needs the queue to be quiescent. */
+MPMCQueue* MPMCQueue_new(void);
+void MPMCQueue_destroy(MPMCQueue* this);
+int MPMCQueue_push(MPMCQueue* this, const void* value);
+int MPMCQueue_pop(MPMCQueue* this, void** value_out);
+bool MPMCQueue_is_empty(MPMCQueue* this);
+
+#endif
@@ -0,0 +1,31 @@
+#include <stdio.h>
+#include "Rope.h"
+
+int main(int argc, const char** argv){
+    Rope* doc = Rope_new_c_str("The quick fox jumps over the dog.");
+    Rope_insert_c_str(doc, 10, "brown ");
+    Rope_insert_c_str(doc, 35, "lazy ");
+    Rope_delete(doc, 0, 4);
+    Rope_insert_c_str(doc, 0, "A ");
+    String* str = Rope_to_str(doc);
+    printf("%s\n", String_data(str));
+    String_destroy(str);
+
+    // ------------------------------------------------------------------------------------
+    printf("\n\n");
+    Rope* big = Rope_new();
+    for(int i=0; i<100000; i++)
+        Rope_append_c_str(big, "0123456789");
+    Rope* part = Rope_substring(big, 499995, 10);
+    Rope_concat(part, doc);
+    Rope_insert_rope(big, 500000, part);
+    printf("%" PRIu64 " bytes, char 500000: %c\n", Rope_len(big), Rope_char_at(big, 500000));
+    uint64_t chunks = 0;
+    StringView* chunk;
+    RopeChunk_for(part, chunk)
+        printf("chunk %" PRIu64 ": %.*s\n", chunks++, (int)chunk->len, chunk->ptr);
+
+    Rope_destroy(part);
+    Rope_destroy(big);
+    Rope_destroy(doc);
+}
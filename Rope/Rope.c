@@ -0,0 +1,381 @@
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "Rope.h"
+
+/* The text lives in the leaves, each holding up to MAX_CHUNK bytes. Inner nodes concatenate
+ * their two children and are kept AVL balanced. Nodes are immutable and reference counted:
+ * an edit builds new nodes along the paths it touches and shares every other subtree, so a
+ * rope, its substrings and the ropes it was concatenated with can all point to one node. */
+#define MAX_CHUNK 1024
+
+struct RopeNode {
+    uint32_t refs;
+    uint32_t height;        /* 0 for leaves */
+    uint64_t length;
+    RopeNode* left;
+    RopeNode* right;
+    char chunk[];           /* leaves only */
+};
+
+struct Rope {
+    RopeNode* root;         /* NULL when empty */
+};
+
+static inline uint32_t height(const RopeNode* node){
+    return node ? node->height : 0;
+}
+
+static inline uint64_t length(const RopeNode* node){
+    return node ? node->length : 0;
+}
+
+static inline RopeNode* retain(RopeNode* node){
+    if(node)
+        node->refs++;
+    return node;
+}
+
+static void release(RopeNode* node){
+    if(node == NULL || --node->refs > 0)
+        return;
+    if(node->height > 0){
+        release(node->left);
+        release(node->right);
+    }
+    free(node);
+}
+
+/* Every function below borrows its node arguments and returns a new reference, or NULL
+ * when out of memory (the empty tree is NULL too, callers tell them apart by length). */
+
+static RopeNode* new_leaf(const char* ptr, uint64_t len, const char* ptr2, uint64_t len2){
+    RopeNode* leaf = malloc(sizeof(RopeNode) + len + len2);
+    if(!leaf)
+        return NULL;
+    leaf->refs = 1;
+    leaf->height = 0;
+    leaf->length = len + len2;
+    leaf->left = leaf->right = NULL;
+    memcpy(leaf->chunk, ptr, len);
+    if(len2)
+        memcpy(leaf->chunk + len, ptr2, len2);
+    return leaf;
+}
+
+static RopeNode* new_inner(RopeNode* left, RopeNode* right){
+    RopeNode* node = malloc(sizeof(RopeNode));
+    if(!node)
+        return NULL;
+    node->refs = 1;
+    node->height = 1 + (left->height > right->height ? left->height : right->height);
+    node->length = left->length + right->length;
+    node->left = retain(left);
+    node->right = retain(right);
+    return node;
+}
+
+/* Joins two balanced trees whose heights differ by at most 2 into a balanced one */
+static RopeNode* balance(RopeNode* left, RopeNode* right){
+    RopeNode *a, *b, *c, *d;    /* the four subtrees, in order, around the two new nodes */
+    if(left->height > right->height + 1){
+        if(left->left->height >= left->right->height){
+            RopeNode* inner = new_inner(left->right, right);
+            if(!inner)
+                return NULL;
+            RopeNode* node = new_inner(left->left, inner);
+            release(inner);
+            return node;
+        }
+        a = left->left; b = left->right->left; c = left->right->right; d = right;
+    }
+    else if(right->height > left->height + 1){
+        if(right->right->height >= right->left->height){
+            RopeNode* inner = new_inner(left, right->left);
+            if(!inner)
+                return NULL;
+            RopeNode* node = new_inner(inner, right->right);
+            release(inner);
+            return node;
+        }
+        a = left; b = right->left->left; c = right->left->right; d = right->right;
+    }
+    else
+        return new_inner(left, right);
+    RopeNode* first = new_inner(a, b);
+    RopeNode* second = new_inner(c, d);
+    RopeNode* node = first && second ? new_inner(first, second) : NULL;
+    release(first);
+    release(second);
+    return node;
+}
+
+/* Concatenation. Descends the taller tree's inner edge to the height of the other one,
+ * so it costs O(height difference). Neighbouring leaves that fit in one chunk are merged. */
+static RopeNode* join(RopeNode* left, RopeNode* right){
+    if(length(left) == 0)
+        return retain(right);
+    if(length(right) == 0)
+        return retain(left);
+    if(left->height == 0 && right->height == 0 && left->length + right->length <= MAX_CHUNK)
+        return new_leaf(left->chunk, left->length, right->chunk, right->length);
+    RopeNode* joined;
+    RopeNode* node;
+    if(left->height > right->height + 1){
+        if(!(joined = join(left->right, right)))
+            return NULL;
+        node = balance(left->left, joined);
+    }
+    else if(right->height > left->height + 1){
+        if(!(joined = join(left, right->left)))
+            return NULL;
+        node = balance(joined, right->right);
+    }
+    else
+        return new_inner(left, right);
+    release(joined);
+    return node;
+}
+
+/* Splits node into the first pos bytes and the rest. Returns -1 when out of memory. */
+static int split(RopeNode* node, uint64_t pos, RopeNode** left_out, RopeNode** right_out){
+    if(pos == 0 || pos >= length(node)){
+        *left_out = pos == 0 ? NULL : retain(node);
+        *right_out = pos == 0 ? retain(node) : NULL;
+        return 0;
+    }
+    if(node->height == 0){
+        *left_out = new_leaf(node->chunk, pos, NULL, 0);
+        *right_out = new_leaf(node->chunk + pos, node->length - pos, NULL, 0);
+        if(*left_out && *right_out)
+            return 0;
+        release(*left_out);
+        release(*right_out);
+        return -1;
+    }
+    RopeNode *first, *second;
+    if(pos < node->left->length){
+        if(split(node->left, pos, &first, &second) == -1)
+            return -1;
+        *left_out = first;
+        *right_out = join(second, node->right);
+        release(second);
+        if(*right_out)
+            return 0;
+        release(first);
+        return -1;
+    }
+    if(split(node->right, pos - node->left->length, &first, &second) == -1)
+        return -1;
+    *left_out = join(node->left, first);
+    *right_out = second;
+    release(first);
+    if(*left_out)
+        return 0;
+    release(second);
+    return -1;
+}
+
+/* Builds a balanced tree of full chunks out of a buffer */
+static RopeNode* build(const char* ptr, uint64_t len){
+    if(len <= MAX_CHUNK)
+        return new_leaf(ptr, len, NULL, 0);
+    uint64_t chunks = (len + MAX_CHUNK - 1) / MAX_CHUNK;
+    uint64_t left_len = chunks / 2 * MAX_CHUNK;
+    RopeNode* left = build(ptr, left_len);
+    RopeNode* right = left ? build(ptr + left_len, len - left_len) : NULL;
+    RopeNode* node = right ? new_inner(left, right) : NULL;
+    release(left);
+    release(right);
+    return node;
+}
+
+/* Replaces the root with left + middle + right */
+static int Rope_set_joined(Rope* this, RopeNode* left, RopeNode* middle, RopeNode* right){
+    RopeNode* front = join(left, middle);
+    if(!front && length(left) + length(middle) > 0)
+        return -1;
+    RopeNode* root = join(front, right);
+    release(front);
+    if(!root && length(left) + length(middle) + length(right) > 0)
+        return -1;
+    release(this->root);
+    this->root = root;
+    return 0;
+}
+
+/* Rope methods */
+static Rope* Rope_wrap(RopeNode* root){
+    Rope* this = malloc(sizeof(Rope));
+    if(!this){
+        release(root);
+        return NULL;
+    }
+    this->root = root;
+    return this;
+}
+
+Rope* Rope_new(void){
+    return Rope_wrap(NULL);
+}
+
+Rope* Rope_new_n(const char* ptr, uint64_t len){
+    if(len == 0)
+        return Rope_new();
+    RopeNode* root = build(ptr, len);
+    if(!root)
+        return NULL;
+    return Rope_wrap(root);
+}
+
+Rope* Rope_new_c_str(const char* c_str){
+    return Rope_new_n(c_str, strlen(c_str));
+}
+
+Rope* Rope_new_str(const String* str){
+    return Rope_new_n(String_data(str), String_len(str));
+}
+
+Rope* Rope_clone(const Rope* this){
+    return Rope_wrap(retain(this->root));
+}
+
+void Rope_destroy(Rope* this){
+    release(this->root);
+    free(this);
+}
+
+uint64_t Rope_len(const Rope* this){
+    return length(this->root);
+}
+
+/* Returns 0 past the end */
+char Rope_char_at(const Rope* this, uint64_t index){
+    const RopeNode* node = this->root;
+    if(index >= length(node))
+        return 0;
+    while(node->height > 0){
+        if(index < node->left->length)
+            node = node->left;
+        else {
+            index -= node->left->length;
+            node = node->right;
+        }
+    }
+    return node->chunk[index];
+}
+
+static int Rope_insert_node(Rope* this, uint64_t pos, RopeNode* middle){
+    RopeNode *left, *right;
+    if(split(this->root, pos, &left, &right) == -1)
+        return -1;
+    int ret = Rope_set_joined(this, left, middle, right);
+    release(left);
+    release(right);
+    return ret;
+}
+
+int Rope_insert_n(Rope* this, uint64_t pos, const char* ptr, uint64_t len){
+    if(len == 0)
+        return 0;
+    RopeNode* middle = build(ptr, len);
+    if(!middle)
+        return -1;
+    int ret = Rope_insert_node(this, pos, middle);
+    release(middle);
+    return ret;
+}
+
+int Rope_insert_c_str(Rope* this, uint64_t pos, const char* c_str){
+    return Rope_insert_n(this, pos, c_str, strlen(c_str));
+}
+
+int Rope_insert_rope(Rope* this, uint64_t pos, const Rope* other){
+    RopeNode* middle = retain(other->root);     /* other may be this */
+    int ret = Rope_insert_node(this, pos, middle);
+    release(middle);
+    return ret;
+}
+
+int Rope_append_n(Rope* this, const char* ptr, uint64_t len){
+    return Rope_insert_n(this, Rope_len(this), ptr, len);
+}
+
+int Rope_append_c_str(Rope* this, const char* c_str){
+    return Rope_insert_n(this, Rope_len(this), c_str, strlen(c_str));
+}
+
+int Rope_concat(Rope* this, const Rope* other){
+    RopeNode* root = join(this->root, other->root);
+    if(!root && Rope_len(this) + Rope_len(other) > 0)
+        return -1;
+    release(this->root);
+    this->root = root;
+    return 0;
+}
+
+int Rope_delete(Rope* this, uint64_t pos, uint64_t len){
+    uint64_t total = Rope_len(this);
+    if(pos >= total || len == 0)
+        return 0;
+    if(len > total - pos)
+        len = total - pos;
+    RopeNode *left, *rest, *middle, *right;
+    if(split(this->root, pos, &left, &rest) == -1)
+        return -1;
+    int ret = split(rest, len, &middle, &right);
+    release(rest);
+    if(ret == 0){
+        ret = Rope_set_joined(this, left, NULL, right);
+        release(middle);
+        release(right);
+    }
+    release(left);
+    return ret;
+}
+
+Rope* Rope_substring(const Rope* this, uint64_t start, uint64_t len){
+    RopeNode *left, *rest, *middle, *right;
+    if(split(this->root, start, &left, &rest) == -1)
+        return NULL;
+    release(left);
+    int ret = split(rest, len, &middle, &right);
+    release(rest);
+    if(ret == -1)
+        return NULL;
+    release(right);
+    return Rope_wrap(middle);
+}
+
+/* Returns NULL if the text doesn't fit in a String */
+String* Rope_to_str(const Rope* this){
+    if(Rope_len(this) >= UINT_MAX)
+        return NULL;
+    String* str = String_new_reserve(Rope_len(this));
+    if(!str)
+        return NULL;
+    StringView* chunk;
+    RopeChunk_for(this, chunk)
+        String_append_n(str, chunk->ptr, chunk->len);
+    return str;
+}
+
+/* RopeChunkIterator */
+RopeChunkIterator RopeChunkIterator_new(const Rope* rope){
+    RopeChunkIterator iter = {.depth = 0};
+    if(rope->root)
+        iter.stack[iter.depth++] = rope->root;
+    return iter;
+}
+
+StringView* RopeChunkIterator_next(RopeChunkIterator* this){
+    if(this->depth == 0)
+        return NULL;
+    RopeNode* node = this->stack[--this->depth];
+    while(node->height > 0){
+        this->stack[this->depth++] = node->right;
+        node = node->left;
+    }
+    this->chunk = StringView_new(node->chunk, node->length);
+    return &this->chunk;
+}
@@ -0,0 +1,52 @@
+#ifndef _MY_ROPE_
+#define _MY_ROPE_
+#include <inttypes.h>
+#include "../String/String.h"
+#include "../String/StringView.h"
+
+#define ROPE_MAX_HEIGHT 96
+
+/* Opaque types */
+typedef struct Rope Rope;
+typedef struct RopeNode RopeNode;
+
+/* Types */
+typedef struct RopeChunkIterator {
+    RopeNode* stack[ROPE_MAX_HEIGHT];
+    uint32_t depth;
+    StringView chunk;
+} RopeChunkIterator;
+
+/* Rope methods
+ * Text kept as a balanced tree of chunks, so edits anywhere cost O(log n) instead of moving
+ * everything after the edit point. Ropes share chunks: concat, insert_rope and substring
+ * don't copy text, and the ropes involved stay independent afterwards.
+ * Positions past the end are clamped to it. Methods that fail leave the rope unchanged. */
+Rope* Rope_new(void);
+Rope* Rope_new_n(const char* ptr, uint64_t len);
+Rope* Rope_new_c_str(const char* c_str);
+Rope* Rope_new_str(const String* str);
+Rope* Rope_clone(const Rope* this);
+void Rope_destroy(Rope* this);
+uint64_t Rope_len(const Rope* this);
+char Rope_char_at(const Rope* this, uint64_t index);
+int Rope_insert_n(Rope* this, uint64_t pos, const char* ptr, uint64_t len);
+int Rope_insert_c_str(Rope* this, uint64_t pos, const char* c_str);
+int Rope_insert_rope(Rope* this, uint64_t pos, const Rope* other);
+int Rope_append_n(Rope* this, const char* ptr, uint64_t len);
+int Rope_append_c_str(Rope* this, const char* c_str);
+int Rope_concat(Rope* this, const Rope* other);
+int Rope_delete(Rope* this, uint64_t pos, uint64_t len);
+Rope* Rope_substring(const Rope* this, uint64_t start, uint64_t len);
+String* Rope_to_str(const Rope* this);
+
+/* RopeChunkIterator methods + macro
+ * Yields the text in order, one chunk at a time. The rope must not change meanwhile. */
+RopeChunkIterator RopeChunkIterator_new(const Rope* rope);
+StringView* RopeChunkIterator_next(RopeChunkIterator* this);
+
+#define _RopeChunk_for_(_it, _rope, _chunk) for (RopeChunkIterator _it = RopeChunkIterator_new(_rope); (_chunk = RopeChunkIterator_next(&_it)) != NULL; )
+#define RopeChunk_for(rope, chunk) _RopeChunk_for_(_UNIQUE_ID_, rope, chunk)
+
+
+#endif
@@ -0,0 +1,65 @@
+#include "SkipList.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define THREADS 4
+#define EVENTS_PER_THREAD 100000
+
+typedef struct Worker {
+    SkipList* events;
+    int id;
+    uint32_t seed;
+} Worker;
+
+// every worker records events at random timestamps and drops a few old ones
+void* record(void* arg) {
+    Worker* worker = arg;
+    for (uintptr_t i = 0; i < EVENTS_PER_THREAD; i++) {
+        uintptr_t timestamp = (uintptr_t)rand_r(&worker->seed) % 10000000 + 1;
+        SkipList_insert(worker->events, (void*)timestamp, (void*)(uintptr_t)worker->id);
+        if (i % 4 == 0) {
+            SLPair oldest;
+            if (SkipList_ceiling(worker->events, (void*)0, &oldest) == 0)
+                SkipList_remove(worker->events, oldest.key);
+        }
+    }
+    return NULL;
+}
+
+int main(int argc, const char* argv[]) {
+    SkipList* events = SkipList_new_int();
+    pthread_t threads[THREADS];
+    Worker workers[THREADS];
+
+    for (int i = 0; i < THREADS; i++) {
+        workers[i] = (Worker) { .events = events, .id = i, .seed = i + 1 };
+        pthread_create(&threads[i], NULL, record, &workers[i]);
+    }
+    for (int i = 0; i < THREADS; i++)
+        pthread_join(threads[i], NULL);
+    printf("events: %" PRIu64 "\n", SkipList_size(events));
+
+    SLPair pair;
+    if (SkipList_floor(events, (void*)5000000, &pair) == 0)
+        printf("last event at or before 5000000: %lu (worker %lu)\n", (uintptr_t)pair.key, (uintptr_t)pair.value);
+    if (SkipList_ceiling(events, (void*)5000000, &pair) == 0)
+        printf("first event at or after 5000000: %lu (worker %lu)\n", (uintptr_t)pair.key, (uintptr_t)pair.value);
+
+    SLPair* event;
+    int in_window = 0;
+    SLRange_for(events, (void*)5000000, (void*)5010000, iter, event)
+        in_window++;
+    printf("events in [5000000, 5010000): %d\n", in_window);
+
+    SLPair_for(events, iter, event){
+        if((uintptr_t)event->key >= 1000){
+            printf("first event at or after 1000: %lu\n", (uintptr_t)event->key);
+            SLIterator_close(&iter);    /* leaving early */
+            break;
+        }
+    }
+
+    SkipList_destroy(events);
+    return 0;
+}
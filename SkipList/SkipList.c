@@ -0,0 +1,404 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "SkipList.h"
+#include "../Epoch/Epoch.h"
+
+/* A lazy skip list (Herlihy, Lev, Luchangco, Shavit). Lookups walk the list without locks.
+ * An insert locks the predecessors of the new node at each of its levels, checks that they
+ * are still linked to the same successors and links the node bottom up. A remove first marks
+ * the node (that is when it leaves the map), then locks its predecessors and unlinks it at
+ * every level. Locks are always taken in decreasing key order, so writers can't deadlock.
+ * Unlinked nodes are freed through Epoch_retire, since readers may still be on them. */
+
+#define MAX_LEVEL 24    /* node levels are drawn with p = 1/4, plenty for 2^40 entries */
+
+typedef int (*cmp_fn)(const void* , const void* );
+
+struct SLNode {
+    const void* key;
+    _Atomic(void*) value;
+    pthread_mutex_t lock;
+    atomic_bool marked;         /* removed, being unlinked */
+    atomic_bool fully_linked;   /* linked at every level, part of the map */
+    int top_level;
+    _Atomic(SLNode*) next[];    /* top_level + 1 entries */
+};
+
+struct SkipList {
+    SLNode* head;
+    cmp_fn cmp;                 /* NULL: keys are integers */
+    atomic_int level;           /* highest top_level ever inserted, lookups start there */
+    atomic_uint_fast64_t size;
+};
+
+static inline int key_cmp(cmp_fn cmp, const void* a, const void* b){
+    if(cmp == NULL)
+        return ((uintptr_t)a > (uintptr_t)b) - ((uintptr_t)a < (uintptr_t)b);
+    return cmp(a, b);
+}
+
+static int str_cmp(const void* a, const void* b){
+    return strcmp(a, b);
+}
+
+static int random_level(void){
+    static _Thread_local uint64_t state;
+    if(state == 0)
+        state = ((uintptr_t)&state * 0x9E3779B97F4A7C15ull) | 1;
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return __builtin_ctzll(state | (1ull << (2 * (MAX_LEVEL - 1)))) / 2;
+}
+
+static SLNode* SLNode_new(const void* key, const void* value, int top_level){
+    SLNode* node = malloc(sizeof(SLNode) + (top_level + 1) * sizeof(_Atomic(SLNode*)));
+    if(!node)
+        return NULL;
+    node->key = key;
+    atomic_init(&node->value, (void*)value);
+    pthread_mutex_init(&node->lock, NULL);
+    atomic_init(&node->marked, false);
+    atomic_init(&node->fully_linked, false);
+    node->top_level = top_level;
+    for(int level=0; level<=top_level; level++)
+        atomic_init(&node->next[level], NULL);
+    return node;
+}
+
+static void SLNode_free(void* node){
+    pthread_mutex_destroy(&((SLNode*)node)->lock);
+    free(node);
+}
+
+static inline SLNode* next_of(SLNode* node, int level){
+    return atomic_load_explicit(&node->next[level], memory_order_acquire);
+}
+
+static inline bool is_live(SLNode* node){
+    return atomic_load(&node->fully_linked) && !atomic_load(&node->marked);
+}
+
+SkipList* SkipList_new(int (*cmp)(const void* key_a, const void* key_b)){
+    SkipList* this = malloc(sizeof(SkipList));
+    if(!this)
+        return NULL;
+    this->head = SLNode_new(NULL, NULL, MAX_LEVEL - 1);
+    if(!this->head){
+        free(this);
+        return NULL;
+    }
+    this->cmp = cmp;
+    atomic_init(&this->level, 0);
+    atomic_init(&this->size, 0);
+    return this;
+}
+
+SkipList* SkipList_new_str(void){
+    return SkipList_new(str_cmp);
+}
+
+SkipList* SkipList_new_int(void){
+    return SkipList_new(NULL);
+}
+
+void SkipList_clear(SkipList* this){
+    SLNode* node = next_of(this->head, 0);
+    while(node != NULL){
+        SLNode* next = next_of(node, 0);
+        SLNode_free(node);
+        node = next;
+    }
+    for(int level=0; level<MAX_LEVEL; level++)
+        atomic_store(&this->head->next[level], NULL);
+    atomic_store(&this->level, 0);
+    atomic_store(&this->size, 0);
+}
+
+void SkipList_destroy(SkipList* this){
+    SkipList_clear(this);
+    SLNode_free(this->head);
+    free(this);
+}
+
+/* Exact only while no writer is running */
+uint64_t SkipList_size(SkipList* this){
+    return atomic_load(&this->size);
+}
+
+/* Fills preds[level] with the last node whose key is < key and succs[level] with the node
+ * after it, for every level from top down. Returns the highest level where succs holds key, or -1. */
+static int SkipList_find(SkipList* this, const void* key, int top, SLNode** preds, SLNode** succs){
+    int found = -1;
+    SLNode* pred = this->head;
+    for(int level=top; level>=0; level--){
+        SLNode* curr = next_of(pred, level);
+        int c = 1;
+        while(curr && (c = key_cmp(this->cmp, curr->key, key)) < 0){
+            pred = curr;
+            curr = next_of(pred, level);
+        }
+        if(found == -1 && curr && c == 0)
+            found = level;
+        preds[level] = pred;
+        succs[level] = curr;
+    }
+    return found;
+}
+
+/* Higher levels can only repeat the predecessor of the level below, so each node is locked once */
+static void lock_preds(SLNode** preds, int top){
+    for(int level=0; level<=top; level++)
+        if(level == 0 || preds[level] != preds[level - 1])
+            pthread_mutex_lock(&preds[level]->lock);
+}
+
+static void unlock_preds(SLNode** preds, int top){
+    for(int level=0; level<=top; level++)
+        if(level == 0 || preds[level] != preds[level - 1])
+            pthread_mutex_unlock(&preds[level]->lock);
+}
+
+/* Tries to replace the value of a node that holds the key.
+ * Returns false if the node is being removed, the insert then starts over. */
+static bool SkipList_replace(SLNode* node, const void* value){
+    if(atomic_load(&node->marked))
+        return false;
+    while(!atomic_load(&node->fully_linked))
+        ;   /* its insert is finishing */
+    pthread_mutex_lock(&node->lock);
+    bool removed = atomic_load(&node->marked);
+    if(!removed)
+        atomic_store(&node->value, (void*)value);
+    pthread_mutex_unlock(&node->lock);
+    return !removed;
+}
+
+/* Returns 1 if the key was added, 0 if it was present and its value got replaced, -1 on error */
+int SkipList_insert(SkipList* this, const void* key, const void* value){
+    SLNode* preds[MAX_LEVEL];
+    SLNode* succs[MAX_LEVEL];
+    SLNode* node = NULL;
+    int top = random_level();
+    Epoch_enter();
+    while(true){
+        int found = SkipList_find(this, key, MAX_LEVEL - 1, preds, succs);
+        if(found != -1){
+            if(!SkipList_replace(succs[found], value))
+                continue;
+            Epoch_exit();
+            if(node)
+                SLNode_free(node);
+            return 0;
+        }
+        if(!node && !(node = SLNode_new(key, value, top))){
+            Epoch_exit();
+            return -1;
+        }
+        lock_preds(preds, top);
+        bool valid = true;
+        for(int level=0; valid && level<=top; level++){
+            valid = !atomic_load(&preds[level]->marked)
+                && (succs[level] == NULL || !atomic_load(&succs[level]->marked))
+                && next_of(preds[level], level) == succs[level];
+        }
+        if(!valid){
+            unlock_preds(preds, top);
+            continue;
+        }
+        for(int level=0; level<=top; level++)
+            atomic_store_explicit(&node->next[level], succs[level], memory_order_relaxed);
+        for(int level=0; level<=top; level++)
+            atomic_store_explicit(&preds[level]->next[level], node, memory_order_release);
+        atomic_store(&node->fully_linked, true);
+        unlock_preds(preds, top);
+        break;
+    }
+    Epoch_exit();
+    int level = atomic_load(&this->level);
+    while(level < top && !atomic_compare_exchange_weak(&this->level, &level, top))
+        ;
+    atomic_fetch_add(&this->size, 1);
+    return 1;
+}
+
+/* Returns the removed value, or NULL if the key wasn't there */
+void* SkipList_remove(SkipList* this, const void* key){
+    SLNode* preds[MAX_LEVEL];
+    SLNode* succs[MAX_LEVEL];
+    SLNode* victim = NULL;
+    Epoch_enter();
+    while(true){
+        int found = SkipList_find(this, key, MAX_LEVEL - 1, preds, succs);
+        if(victim == NULL){
+            /* a node that isn't fully linked yet is still being inserted: not in the map */
+            if(found == -1 || succs[found]->top_level != found || !is_live(succs[found]))
+                break;
+            victim = succs[found];
+            pthread_mutex_lock(&victim->lock);
+            if(atomic_load(&victim->marked)){
+                pthread_mutex_unlock(&victim->lock);
+                victim = NULL;
+                break;
+            }
+            atomic_store(&victim->marked, true);
+        }
+        int top = victim->top_level;
+        lock_preds(preds, top);
+        bool valid = true;
+        for(int level=0; valid && level<=top; level++)
+            valid = !atomic_load(&preds[level]->marked) && next_of(preds[level], level) == victim;
+        if(!valid){
+            unlock_preds(preds, top);
+            continue;
+        }
+        for(int level=top; level>=0; level--)
+            atomic_store_explicit(&preds[level]->next[level], next_of(victim, level), memory_order_release);
+        pthread_mutex_unlock(&victim->lock);
+        unlock_preds(preds, top);
+        break;
+    }
+    Epoch_exit();
+    if(victim == NULL)
+        return NULL;
+    void* value = atomic_load(&victim->value);
+    atomic_fetch_sub(&this->size, 1);
+    Epoch_retire(victim, SLNode_free);
+    return value;
+}
+
+/* The first node with a key >= key, live or not. Sets *pred to the node before it (maybe the head).
+ * Must be called inside an epoch section. */
+static SLNode* SkipList_lower_bound(SkipList* this, const void* key, SLNode** pred_out){
+    SLNode* pred = this->head;
+    SLNode* curr = NULL;
+    for(int level=atomic_load(&this->level); level>=0; level--){
+        curr = next_of(pred, level);
+        while(curr && key_cmp(this->cmp, curr->key, key) < 0){
+            pred = curr;
+            curr = next_of(pred, level);
+        }
+    }
+    if(pred_out)
+        *pred_out = pred;
+    return curr;
+}
+
+static SLNode* skip_dead(SLNode* node){
+    while(node && !is_live(node))
+        node = next_of(node, 0);
+    return node;
+}
+
+void* SkipList_get(SkipList* this, const void* key){
+    void* value = NULL;
+    Epoch_enter();
+    SLNode* node = SkipList_lower_bound(this, key, NULL);
+    if(node && is_live(node) && key_cmp(this->cmp, node->key, key) == 0)
+        value = atomic_load(&node->value);
+    Epoch_exit();
+    return value;
+}
+
+bool SkipList_contains(SkipList* this, const void* key){
+    Epoch_enter();
+    SLNode* node = SkipList_lower_bound(this, key, NULL);
+    bool found = node && is_live(node) && key_cmp(this->cmp, node->key, key) == 0;
+    Epoch_exit();
+    return found;
+}
+
+/* The entry with the greatest key <= key. Returns -1 if there is none. */
+int SkipList_floor(SkipList* this, const void* key, SLPair* pair_out){
+    SLNode* result = NULL;
+    Epoch_enter();
+    const void* bound = key;
+    bool inclusive = true;
+    while(true){
+        SLNode* pred;
+        SLNode* node = SkipList_lower_bound(this, bound, &pred);
+        if(inclusive && node && is_live(node) && key_cmp(this->cmp, node->key, key) == 0){
+            result = node;
+            break;
+        }
+        if(pred == this->head)
+            break;
+        if(is_live(pred)){
+            result = pred;
+            break;
+        }
+        /* pred is coming or going, look for the live one before it */
+        bound = pred->key;
+        inclusive = false;
+    }
+    if(result){
+        pair_out->key = result->key;
+        pair_out->value = atomic_load(&result->value);
+    }
+    Epoch_exit();
+    return result ? 0 : -1;
+}
+
+/* The entry with the smallest key >= key. Returns -1 if there is none. */
+int SkipList_ceiling(SkipList* this, const void* key, SLPair* pair_out){
+    Epoch_enter();
+    SLNode* result = skip_dead(SkipList_lower_bound(this, key, NULL));
+    if(result){
+        pair_out->key = result->key;
+        pair_out->value = atomic_load(&result->value);
+    }
+    Epoch_exit();
+    return result ? 0 : -1;
+}
+
+SLIterator SLIterator_new(SkipList* list){
+    Epoch_enter();
+    return (SLIterator) {
+        .list = list,
+        .node = skip_dead(next_of(list->head, 0)),
+        .hi_key = NULL,
+        .bounded = false,
+        .in_section = true
+    };
+}
+
+SLIterator SLIterator_new_range(SkipList* list, const void* lo_key, const void* hi_key){
+    Epoch_enter();
+    return (SLIterator) {
+        .list = list,
+        .node = skip_dead(SkipList_lower_bound(list, lo_key, NULL)),
+        .hi_key = hi_key,
+        .bounded = true,
+        .in_section = true
+    };
+}
+
+void SLIterator_close(SLIterator* this){
+    if(this->in_section){
+        this->in_section = false;
+        this->node = NULL;
+        Epoch_exit();
+    }
+}
+
+SLPair* SLIterator_peak(SLIterator* this){
+    if(!this->in_section)
+        return NULL;
+    SLNode* node = this->node;
+    if(node == NULL || (this->bounded && key_cmp(this->list->cmp, node->key, this->hi_key) >= 0)){
+        SLIterator_close(this);
+        return NULL;
+    }
+    this->pair.key = node->key;
+    this->pair.value = atomic_load(&node->value);
+    return &(this->pair);
+}
+
+SLPair* SLIterator_next(SLIterator* this){
+    SLPair* pair = SLIterator_peak(this);
+    if(pair)
+        this->node = skip_dead(next_of(this->node, 0));
+    return pair;
+}
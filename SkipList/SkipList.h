@@ -0,0 +1,60 @@
+#ifndef _MY_SKIP_LIST_
+#define _MY_SKIP_LIST_
+#include <inttypes.h>
+#include <stdbool.h>
+
+/* Opaque types */
+typedef struct SkipList SkipList;
+typedef struct SLNode SLNode;
+
+/* Types */
+typedef struct SLPair {
+    const void* key;
+    void* value;
+} SLPair;
+
+typedef struct SLIterator {
+    SkipList* list;
+    SLNode* node;
+    const void* hi_key;
+    bool bounded;
+    bool in_section;
+    SLPair pair;
+} SLIterator;
+
+/* SkipList methods
+ * Ordered map that any number of threads can read and update at once. Lookups never block,
+ * writers lock the nodes next to the one they change. Keys and values are not owned: a thread
+ * that removes an entry and wants to free its key or value while others may still be reading
+ * it should pass them to Epoch_retire (../Epoch/Epoch.h).
+ * SkipList_new_int() maps integer keys (cast to pointers) and compares them without a callback.
+ * destroy and clear need the list to be quiescent. */
+SkipList* SkipList_new(int (*cmp)(const void* key_a, const void* key_b));
+SkipList* SkipList_new_str(void);
+SkipList* SkipList_new_int(void);
+void SkipList_destroy(SkipList* this);
+void SkipList_clear(SkipList* this);
+uint64_t SkipList_size(SkipList* this);
+int SkipList_insert(SkipList* this, const void* key, const void* value);
+void* SkipList_remove(SkipList* this, const void* key);
+bool SkipList_contains(SkipList* this, const void* key);
+void* SkipList_get(SkipList* this, const void* key);
+int SkipList_floor(SkipList* this, const void* key, SLPair* pair_out);
+int SkipList_ceiling(SkipList* this, const void* key, SLPair* pair_out);
+
+/* SLIterator methods + macros. Ranges are [lo_key, hi_key).
+ * An iterator sees every entry that stays in the list while it runs, in order. It keeps the
+ * thread inside an epoch section until it reaches the end, and while it does nothing retired
+ * through Epoch (by any SkipList or MPMCQueue) can be freed. A loop that may stop early (break,
+ * return, goto) must call SLIterator_close on the iterator, which the macros name for that. */
+SLIterator SLIterator_new(SkipList* list);
+SLIterator SLIterator_new_range(SkipList* list, const void* lo_key, const void* hi_key);
+SLPair* SLIterator_peak(SLIterator* this);
+SLPair* SLIterator_next(SLIterator* this);
+void SLIterator_close(SLIterator* this);
+
+#define SLPair_for(list, iter, pair) for (SLIterator iter = SLIterator_new(list); (pair = SLIterator_next(&iter)) != NULL; )
+#define SLRange_for(list, lo, hi, iter, pair) for (SLIterator iter = SLIterator_new_range(list, lo, hi); (pair = SLIterator_next(&iter)) != NULL; )
+
+
+#endif
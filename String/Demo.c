@@ -1,4 +1,5 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include "String.h"
 #include "../List/List.h"
 
@@ -37,4 +38,31 @@ int main(int argc, const char** argv){
     List_map(cells, (void (*)(void* ))String_destroy);
     List_destroy(cells);
     String_destroy(str);
+
+    // ------------------------------------------------------------------------------------
+    printf("\n\n");
+    String* log = String_new_copy("GET /a 200\nGET /b 404\nPOST /c 200\nGET /d 200\n");
+    unsigned int count;
+    unsigned int* offsets = String_find_all(log, " 200", &count);
+    for(unsigned int i=0; i<count; i++)
+        printf("200 at %u\n", offsets[i]);
+    free(offsets);
+    StringNeedle* get = StringNeedle_new("GET");
+    printf("third GET at %d\n", String_find_needle(log, get, 2));
+    StringNeedle_destroy(get);
+    String_destroy(log);
+
+    // ------------------------------------------------------------------------------------
+    printf("\n\n");
+    String* path = String_new();
+    String_reserve(path, 64);
+    String_append_n(path, "/usr/local/bin", 10);
+    const char* parts[] = {"/", "share", "/", String_data(path)};
+    String_append_many(path, parts, NULL, 4);     /* the last part is path itself */
+    printf("%s (%u)\n", String_data(path), String_len(path));
+    const char* twice[] = {String_data(path), String_data(path)};
+    unsigned int lens[] = {4, 10};
+    String_append_many(path, twice, lens, 2);
+    printf("%s (%u)\n", String_data(path), String_len(path));
+    String_destroy(path);
 }
\ No newline at end of file
@@ -0,0 +1,36 @@
+#include <stdio.h>
+#include "StringView.h"
+
+int main(int argc, const char** argv){
+    const char* csv = "id, name ,score\n1,alice, 90\n2, bob,-7\n3,carol,x\n";
+
+    StringView* line;
+    StringView* cell;
+    SVSplit_for(StringView_from_c_str(csv), StringView_from_c_str("\n"), line){
+        if(line->len == 0)
+            continue;
+        int column = 0;
+        SVSplit_for(*line, StringView_from_c_str(","), cell){
+            StringView field = StringView_trim(*cell);
+            int64_t score;
+            if(column++ == 2 && StringView_parse_int(field, &score) == 0)
+                printf("[%" PRId64 "] ", score);
+            else
+                printf("{%.*s} ", (int)field.len, field.ptr);
+        }
+        putc('\n', stdout);
+    }
+
+    // ------------------------------------------------------------------------------------
+    printf("\n\n");
+    StringView* token;
+    SVToken_for(StringView_from_c_str("  GET /index.html\tHTTP/1.1  "), " \t", token)
+        printf("<%.*s>\n", (int)token->len, token->ptr);
+
+    StringView path = StringView_from_c_str("/var/log/app.log");
+    printf("ends with .log: %d\n", StringView_ends_with(path, StringView_from_c_str(".log")));
+    printf("'log' at %" PRId64 "\n", StringView_find(path, StringView_from_c_str("log")));
+    String* owned = StringView_to_str(StringView_substr(path, 5, 3));
+    printf("%s\n", String_data(owned));
+    String_destroy(owned);
+}
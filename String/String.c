@@ -1,60 +1,102 @@
 #include "String.h"
+#include "StringHash.h"
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 typedef unsigned int uint;
 
+/* Strings shorter than LOCAL_SIZE live in the String object itself, c_str points to local.
+ * Longer ones move to the heap and stay there until shrink_to_fit. */
+#define LOCAL_SIZE 24
+
 struct String {
     char* c_str;
     uint length, size;
+    _Atomic uint64_t hash;  /* HASH_CACHED | hash, 0 until computed. Changes to the contents clear it. */
+    char local[LOCAL_SIZE];
 };
 
+#define HASH_CACHED (1ull << 32)
 
+static inline void String_clear_hash(String* this){
+    atomic_store_explicit(&this->hash, 0, memory_order_relaxed);
+}
 
-const uint DEF_SIZE = 20;               /* used by empty constructor */
+static inline int String_is_local(const String* this){
+    return this->c_str == this->local;
+}
+
+static inline void String_free_data(String* this){
+    if(!String_is_local(this))
+        free(this->c_str);
+}
+
+/* Resizes the buffer to new_size, moving it out of the object if needed */
+static int String_resize(String* this, uint new_size){
+    char* new_c_str;
+    if(String_is_local(this)){
+        new_c_str = malloc(new_size);
+        if(!new_c_str)
+            return -1;
+        memcpy(new_c_str, this->local, this->length + 1);
+    }
+    else if(!(new_c_str = realloc(this->c_str, new_size)))
+        return -1;
+    this->size = new_size;
+    this->c_str = new_c_str;
+    return 0;
+}
+
+/* Sets up an empty string with room for size characters plus the terminator.
+ * Frees this and returns NULL on failure. */
+static String* String_init(String* this, uint size){
+    if(size < LOCAL_SIZE){
+        this->c_str = this->local;
+        this->size = LOCAL_SIZE;
+    }
+    else {
+        this->c_str = malloc(size + 1);
+        if(!this->c_str){
+            free(this);
+            return NULL;
+        }
+        this->size = size + 1;
+    }
+    this->length = 0;
+    String_clear_hash(this);
+    this->c_str[0] = '\0';
+    return this;
+}
 
 /* String methods */
 String* String_new(){
     String* this = malloc(sizeof(String));
     if(!this)
         return NULL;
-    this->c_str = malloc(DEF_SIZE);
-    if(!this->c_str){
-        free(this);
-        return NULL;
-    }
-    this->size = DEF_SIZE;
-    this->length = 0;
-    this->c_str[0] = '\0';
-    return this;
+    return String_init(this, 0);
 }
 
 String* String_new_reserve(uint size){
     String* this = malloc(sizeof(String));
     if(!this)
         return NULL;
-    this->c_str = malloc(size + 1);
-    if(!this->c_str){
-        free(this);
-        return NULL;
-    }
-    this->size = size + 1;
-    this->length = 0;
-    return this;
+    return String_init(this, size);
 }
 
 String* String_new_copy(const char* c_str){
     String* this = malloc(sizeof(String));
-    this->length = strlen(c_str);
-    this->size = this->length + 1;
     if(!this)
         return NULL;
-    this->c_str = malloc(this->size);
-    if(!this->c_str){
-        free(this);
+    uint length = strlen(c_str);
+    if(!String_init(this, length))
         return NULL;
-    }
-    strncpy(this->c_str, c_str, this->size);
+    memcpy(this->c_str, c_str, length + 1);
+    this->length = length;
     return this;
 }
 
@@ -62,29 +104,21 @@ String* String_clone(const String* this){
     String* clone = malloc(sizeof(String));
     if(!clone)
         return NULL;
-    clone->c_str = String_clone_data(this);
-    if(!clone->c_str){
-        free(clone);
+    if(!String_init(clone, this->length))
         return NULL;
-    }
+    memcpy(clone->c_str, this->c_str, this->length + 1);
     clone->length = this->length;
-    clone->size = this->length + 1;
+    atomic_store_explicit(&clone->hash, atomic_load_explicit(&this->hash, memory_order_relaxed), memory_order_relaxed);
     return clone;
 }
 
 void String_destroy(String* this){
-    free(this->c_str);
+    String_free_data(this);
     free(this);
 }
 
 static int String_expand(String* this, unsigned int new_len){
-    uint new_size = new_len + 1 + this->size * 2;
-    char* new_c_str = realloc(this->c_str, new_size);
-    if(!new_c_str)
-        return -1;
-    this->size = new_size;
-    this->c_str = new_c_str;
-    return 0;
+    return String_resize(this, new_len + 1 + this->size * 2);
 }
 
 const char* String_data(const String* this){
@@ -95,44 +129,97 @@ char* String_clone_data(const String* this){
     char* clone = malloc(this->length + 1);
     if(!clone)
         return NULL;
-    strncpy(clone, this->c_str, this->size);
+    memcpy(clone, this->c_str, this->length + 1);
     return clone;
 }
 
-int String_append_str(String* this, const String* str){
-    uint combined_len = this->length + str->length;
-    if(combined_len >= this->size)
+/* Makes room for a string of capacity characters (not counting the terminator) */
+int String_reserve(String* this, unsigned int capacity){
+    if(capacity < this->size)
+        return 0;
+    return String_resize(this, capacity + 1);
+}
+
+static inline int String_owns(const String* this, const char* ptr){
+    return (uintptr_t)ptr >= (uintptr_t)this->c_str && (uintptr_t)ptr < (uintptr_t)(this->c_str + this->size);
+}
+
+/* Appends len bytes from ptr, which may point into this string */
+int String_append_n(String* this, const char* ptr, unsigned int len){
+    uint combined_len = this->length + len;
+    if(combined_len >= this->size){
+        uintptr_t offset = ptr - this->c_str;
+        int owned = String_owns(this, ptr);
         if(String_expand(this, combined_len) == -1)
             return -1;
-    if(this == str){
-        uint tmp_size = str->length + 1;
-        char* tmp = malloc(tmp_size);
-        if(!tmp)
-            return -1;
-        strncpy(tmp, str->c_str, tmp_size);
-        strncat(this->c_str, tmp, tmp_size);
-        free(tmp);
+        if(owned)
+            ptr = this->c_str + offset;
     }
-    else
-        strncat(this->c_str, str->c_str, this->size);
+    memmove(this->c_str + this->length, ptr, len);
     this->length = combined_len;
+    this->c_str[combined_len] = '\0';
+    String_clear_hash(this);
     return 0;
 }
 
+int String_append_str(String* this, const String* str){
+    return String_append_n(this, str->c_str, str->length);
+}
+
 int String_append_c_str(String* this, const char* c_str){
-    uint c_str_len = strlen(c_str);
-    uint combined_len = this->length + c_str_len;
-    if(combined_len >= this->size)
-        if(String_expand(this, combined_len) == -1)
+    return String_append_n(this, c_str, strlen(c_str));
+}
+
+/* Appends count strings with a single reallocation. lens holds their lengths, or is NULL
+ * if they are null terminated. The parts may point into this string. Lengths are measured
+ * once, up front: a part inside this string loses its terminator to the first copy. */
+#define APPEND_MANY_LOCAL_LENS 16
+
+int String_append_many(String* this, const char* const* parts, const unsigned int* lens, unsigned int count){
+    uint local_lens[APPEND_MANY_LOCAL_LENS];
+    uint* measured = NULL;
+    if(!lens){
+        measured = count <= APPEND_MANY_LOCAL_LENS ? local_lens : malloc(count * sizeof(uint));
+        if(!measured)
             return -1;
-    uint tmp_size = c_str_len + 1;
-    char* tmp = malloc(tmp_size);
-    if(!tmp)
-        return -1;
-    strncpy(tmp, c_str, tmp_size);
-    strncat(this->c_str, tmp, tmp_size);
-    free(tmp);
-    this->length = combined_len;
+        for(uint i=0; i<count; i++)
+            measured[i] = strlen(parts[i]);
+        lens = measured;
+    }
+    uint combined_len = this->length;
+    int owned = 0;
+    for(uint i=0; i<count; i++){
+        combined_len += lens[i];
+        owned |= String_owns(this, parts[i]);
+    }
+    char* c_str = this->c_str;
+    if(combined_len >= this->size){
+        /* parts inside the old buffer stay readable until everything is copied */
+        uint new_size = combined_len + 1 + this->size * 2;
+        int fresh = owned || String_is_local(this);
+        c_str = fresh ? malloc(new_size) : realloc(this->c_str, new_size);
+        if(!c_str){
+            if(measured != local_lens)
+                free(measured);
+            return -1;
+        }
+        if(fresh)
+            memcpy(c_str, this->c_str, this->length);
+        this->size = new_size;
+    }
+    uint length = this->length;
+    for(uint i=0; i<count; i++){
+        memmove(c_str + length, parts[i], lens[i]);
+        length += lens[i];
+    }
+    c_str[length] = '\0';
+    if(owned && c_str != this->c_str)
+        String_free_data(this);
+    this->c_str = c_str;
+    this->length = length;
+    String_clear_hash(this);
+    if(measured != local_lens)
+        free(measured);
     return 0;
 }
 
@@ -143,6 +230,7 @@ int String_append_char(String* this, char c){
             return -1;
     this->c_str[this->length++] = c;
     this->c_str[this->length] = '\0';
+    String_clear_hash(this);
     return 0;
 }
 
@@ -174,58 +262,325 @@ unsigned int String_len(const String* this){
 }
 
 
+/* HashTable's default hash before the modulo. Computed on first use and kept until the
+ * contents change, the cache is not part of the value so it is updated through const.
+ * The cache is a relaxed atomic: threads hashing the same shared const String at once all
+ * store the same value, which is safe. */
+unsigned int String_hash(const String* this){
+    uint64_t cached = atomic_load_explicit(&this->hash, memory_order_relaxed);
+    if(cached & HASH_CACHED)
+        return (uint32_t)cached;
+    uint32_t hash_value = string_hash_n(this->c_str, this->length);
+    String* mutable_this = (String*)this;
+    atomic_store_explicit(&mutable_this->hash, HASH_CACHED | hash_value, memory_order_relaxed);
+    return hash_value;
+}
+
 int String_is_equal(const String* str1, const String* str2){
-    return strcmp(str1->c_str, str2->c_str) == 0;
+    if(str1->length != str2->length)
+        return 0;
+    uint64_t hash1 = atomic_load_explicit(&str1->hash, memory_order_relaxed);
+    uint64_t hash2 = atomic_load_explicit(&str2->hash, memory_order_relaxed);
+    if((hash1 & hash2 & HASH_CACHED) && hash1 != hash2)
+        return 0;
+    return memcmp(str1->c_str, str2->c_str, str1->length) == 0;
 }
 
+/* strnlen first: the String may hold a '\0', and c_str can't be read past its terminator */
 int String_is_equal_c_str(const String* this, const char* c_str){
-    return strcmp(this->c_str, c_str) == 0;
+    return strnlen(c_str, this->length + 1) == this->length && memcmp(this->c_str, c_str, this->length) == 0;
 }
 
-int String_find(const String* haystack, const String* needle, uint occurrence){
-    char* str_ptr = haystack->c_str;
-    char* occurrence_idx;
-    for(uint i=0; i<=occurrence; i++){
-        occurrence_idx = strstr(str_ptr, needle->c_str);
-        if(!occurrence_idx)
-            return -1;
-        str_ptr = occurrence_idx + 1;
+/* Substring search
+ * Short needles are found with a SIMD filter: a block of 16 haystack positions is kept only
+ * where both the first and the last byte of the needle match, and just those positions are
+ * compared in full. Needles of TWO_WAY_MIN_LEN bytes or more use Two-Way (Crochemore-Perrin),
+ * which never looks at a haystack byte more than twice however repetitive the input is.
+ * Every search reports all matches, overlapping ones included, in order. */
+#define TWO_WAY_MIN_LEN 32
+
+struct StringNeedle {
+    const unsigned char* bytes;
+    uint64_t length;
+    int64_t critical;   /* Two-Way critical factorization: bytes[0..critical] | bytes[critical+1..] */
+    uint64_t period;
+    int periodic;       /* whether period is the exact period of the needle */
+    unsigned char owned_bytes[];
+};
+
+/* Start of the maximal suffix of x, under the normal or the reversed byte order */
+static int64_t max_suffix(const unsigned char* x, int64_t m, uint64_t* period, int reversed){
+    int64_t ms = -1, j = 0, k = 1;
+    int64_t p = 1;
+    while(j + k < m){
+        unsigned char a = x[j + k], b = x[ms + k];
+        if(reversed ? a > b : a < b){
+            j += k;
+            k = 1;
+            p = j - ms;
+        }
+        else if(a == b){
+            if(k != p)
+                k++;
+            else {
+                j += p;
+                k = 1;
+            }
+        }
+        else {
+            ms = j;
+            j = ms + 1;
+            k = p = 1;
+        }
+    }
+    *period = p;
+    return ms;
+}
+
+static void StringNeedle_prepare(StringNeedle* this, const char* bytes, uint64_t length){
+    this->bytes = (const unsigned char*)bytes;
+    this->length = length;
+    if(length < TWO_WAY_MIN_LEN)
+        return;
+    uint64_t p, q;
+    int64_t i = max_suffix(this->bytes, length, &p, 0);
+    int64_t j = max_suffix(this->bytes, length, &q, 1);
+    this->critical = i > j ? i : j;
+    this->period = i > j ? p : q;
+    this->periodic = memcmp(this->bytes, this->bytes + this->period, this->critical + 1) == 0;
+    if(!this->periodic){
+        uint64_t left = this->critical + 1, right = length - this->critical - 1;
+        this->period = (left > right ? left : right) + 1;
+    }
+}
+
+/* The scanners work on plain buffers, so that views can be searched as well as Strings.
+ * hit returns 0 to stop the scan. */
+typedef int (*HitFn)(void* ctx, uint64_t offset);
+
+static void two_way_scan(const StringNeedle* this, const unsigned char* hay, uint64_t hay_len, uint64_t start, HitFn hit, void* ctx){
+    const unsigned char* x = this->bytes;
+    int64_t m = this->length, ell = this->critical;
+    int64_t memory = -1;
+    for(uint64_t j=start; j + m <= hay_len; ){
+        int64_t i = (ell > memory ? ell : memory) + 1;
+        while(i < m && x[i] == hay[i + j])
+            i++;
+        if(i < m){
+            j += i - ell;
+            memory = -1;
+            continue;
+        }
+        i = ell;
+        while(i > memory && x[i] == hay[i + j])
+            i--;
+        if(i <= memory && !hit(ctx, j))
+            return;
+        j += this->period;
+        memory = this->periodic ? m - (int64_t)this->period - 1 : -1;
+    }
+}
+
+static void filter_scan(const StringNeedle* this, const unsigned char* hay, uint64_t hay_len, uint64_t start, HitFn hit, void* ctx){
+    const unsigned char* x = this->bytes;
+    uint64_t m = this->length;
+    uint64_t i = start;
+    if(m == 1){
+        const unsigned char* ptr;
+        while(i < hay_len && (ptr = memchr(hay + i, x[0], hay_len - i))){
+            if(!hit(ctx, ptr - hay))
+                return;
+            i = ptr - hay + 1;
+        }
+        return;
+    }
+#ifdef __SSE2__
+    const __m128i first = _mm_set1_epi8(x[0]), last = _mm_set1_epi8(x[m - 1]);
+    for(; i + m - 1 + 16 <= hay_len; i += 16){
+        __m128i block_first = _mm_loadu_si128((const __m128i*)(hay + i));
+        __m128i block_last = _mm_loadu_si128((const __m128i*)(hay + i + m - 1));
+        uint mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(block_first, first), _mm_cmpeq_epi8(block_last, last)));
+        while(mask){
+            uint64_t pos = i + __builtin_ctz(mask);
+            if(memcmp(hay + pos + 1, x + 1, m - 2) == 0 && !hit(ctx, pos))
+                return;
+            mask &= mask - 1;
+        }
+    }
+#endif
+    for(; i + m <= hay_len; i++)
+        if(hay[i] == x[0] && hay[i + m - 1] == x[m - 1] && memcmp(hay + i + 1, x + 1, m - 2) == 0 && !hit(ctx, i))
+            return;
+}
+
+static void StringNeedle_scan(const StringNeedle* this, const char* haystack, uint64_t hay_len, uint64_t start, HitFn hit, void* ctx){
+    const unsigned char* hay = (const unsigned char*)haystack;
+    if(this->length == 0){
+        for(uint64_t i=start; i<=hay_len; i++)
+            if(!hit(ctx, i))
+                return;
     }
-    return occurrence_idx - haystack->c_str;
+    else if(this->length > hay_len)
+        return;
+    else if(this->length < TWO_WAY_MIN_LEN)
+        filter_scan(this, hay, hay_len, start, hit, ctx);
+    else
+        two_way_scan(this, hay, hay_len, start, hit, ctx);
+}
+
+StringNeedle* StringNeedle_new(const char* c_str){
+    uint length = strlen(c_str);
+    StringNeedle* this = malloc(sizeof(StringNeedle) + length + 1);
+    if(!this)
+        return NULL;
+    memcpy(this->owned_bytes, c_str, length + 1);
+    StringNeedle_prepare(this, (const char*)this->owned_bytes, length);
+    return this;
+}
+
+StringNeedle* StringNeedle_new_str(const String* str){
+    return StringNeedle_new(str->c_str);
+}
+
+void StringNeedle_destroy(StringNeedle* this){
+    free(this);
+}
+
+unsigned int StringNeedle_len(const StringNeedle* this){
+    return this->length;
+}
+
+typedef struct Occurrence {
+    uint remaining;
+    int64_t offset;
+} Occurrence;
+
+static int find_hit(void* ctx, uint64_t offset){
+    Occurrence* occ = ctx;
+    if(occ->remaining-- > 0)
+        return 1;
+    occ->offset = offset;
+    return 0;
+}
+
+int String_find_needle(const String* haystack, const StringNeedle* needle, unsigned int occurrence){
+    Occurrence occ = {.remaining = occurrence, .offset = -1};
+    StringNeedle_scan(needle, haystack->c_str, haystack->length, 0, find_hit, &occ);
+    return occ.offset;
+}
+
+int String_find(const String* haystack, const String* needle, uint occurrence){
+    StringNeedle prepared;
+    StringNeedle_prepare(&prepared, needle->c_str, needle->length);
+    return String_find_needle(haystack, &prepared, occurrence);
 }
 
 int String_find_c_str(const String* haystack, const char* needle, unsigned int occurrence){
-    char* str_ptr = haystack->c_str;
-    char* occurrence_idx;
-    for(uint i=0; i<=occurrence; i++){
-        occurrence_idx = strstr(str_ptr, needle);
-        if(!occurrence_idx)
-            return -1;
-        str_ptr = occurrence_idx + 1;
+    StringNeedle prepared;
+    StringNeedle_prepare(&prepared, needle, strlen(needle));
+    return String_find_needle(haystack, &prepared, occurrence);
+}
+
+int64_t String_find_n(const char* haystack, uint64_t haystack_len, const char* needle, uint64_t needle_len){
+    StringNeedle prepared;
+    StringNeedle_prepare(&prepared, needle, needle_len);
+    Occurrence occ = {.remaining = 0, .offset = -1};
+    StringNeedle_scan(&prepared, haystack, haystack_len, 0, find_hit, &occ);
+    return occ.offset;
+}
+
+typedef struct Offsets {
+    uint* offsets;
+    uint count, capacity;
+    int failed;
+} Offsets;
+
+static int find_all_hit(void* ctx, uint64_t offset){
+    Offsets* all = ctx;
+    if(all->count == all->capacity){
+        uint* offsets = realloc(all->offsets, 2 * all->capacity * sizeof(uint));
+        if(!offsets){
+            all->failed = 1;
+            return 0;
+        }
+        all->offsets = offsets;
+        all->capacity *= 2;
+    }
+    all->offsets[all->count++] = offset;
+    return 1;
+}
+
+unsigned int* String_find_all_needle(const String* haystack, const StringNeedle* needle, unsigned int* count_out){
+    Offsets all = {.offsets = malloc(16 * sizeof(uint)), .count = 0, .capacity = 16, .failed = 0};
+    if(!all.offsets)
+        return NULL;
+    StringNeedle_scan(needle, haystack->c_str, haystack->length, 0, find_all_hit, &all);
+    if(all.failed){
+        free(all.offsets);
+        return NULL;
     }
-    return occurrence_idx - haystack->c_str;
+    *count_out = all.count;
+    return all.offsets;
+}
+
+unsigned int* String_find_all(const String* haystack, const char* needle, unsigned int* count_out){
+    StringNeedle prepared;
+    StringNeedle_prepare(&prepared, needle, strlen(needle));
+    return String_find_all_needle(haystack, &prepared, count_out);
 }
 
 void String_shrink_to_fit(String* this){
+    if(String_is_local(this))
+        return;
+    if(this->length < LOCAL_SIZE){
+        memcpy(this->local, this->c_str, this->length + 1);
+        free(this->c_str);
+        this->c_str = this->local;
+        this->size = LOCAL_SIZE;
+        return;
+    }
     uint new_size = this->length + 1;
-    this->c_str = realloc(this->c_str, new_size);
+    char* new_c_str = realloc(this->c_str, new_size);
+    if(!new_c_str)
+        return;
+    this->c_str = new_c_str;
     this->size = new_size;
 }
 
+static String* String_new_n(const char* ptr, uint len){
+    String* this = String_new_reserve(len);
+    if(!this)
+        return NULL;
+    memcpy(this->c_str, ptr, len);
+    this->c_str[len] = '\0';
+    this->length = len;
+    return this;
+}
+
+typedef struct Splitter {
+    const String* string;
+    List* pieces;
+    uint piece_start;
+    uint delim_len;
+} Splitter;
+
+static int split_hit(void* ctx, uint64_t offset){
+    Splitter* splitter = ctx;
+    if(offset < splitter->piece_start)     /* overlaps the previous delimiter */
+        return 1;
+    List_append(splitter->pieces, String_new_n(splitter->string->c_str + splitter->piece_start, offset - splitter->piece_start));
+    splitter->piece_start = offset + splitter->delim_len;
+    return 1;
+}
+
 List* String_split(String* this, const char* delim){
-    List* list = List_new();
-    uint delim_len = strlen(delim);
-    char* str_ptr = this->c_str;
-    char* delim_occ;
-    while(delim_occ = strstr(str_ptr, delim)){
-        if(delim_occ == str_ptr)
-            List_append(list, String_new());
-        else
-            List_append(list, String_substring(this, str_ptr - this->c_str, (delim_occ - this->c_str) - 1));
-        str_ptr = delim_occ + delim_len;
-    }
-    List_append(list, String_substring(this, str_ptr - this->c_str, this->length));
-    return list;
+    StringNeedle prepared;
+    StringNeedle_prepare(&prepared, delim, strlen(delim));
+    Splitter splitter = {.string = this, .pieces = List_new(), .piece_start = 0, .delim_len = prepared.length};
+    if(prepared.length != 0)
+        StringNeedle_scan(&prepared, this->c_str, this->length, 0, split_hit, &splitter);
+    List_append(splitter.pieces, String_new_n(this->c_str + splitter.piece_start, this->length - splitter.piece_start));
+    return splitter.pieces;
 }
 
 /* StringIterator */
@@ -286,5 +641,6 @@ int StringIterator_modify(StringIterator* this, char c){
     if((this->index < 0) || (this->index >= this->string->length))
         return -1;
     this->string->c_str[this->index] = c;
+    String_clear_hash(this->string);
     return 0;
 }
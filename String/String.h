@@ -1,10 +1,12 @@
 #ifndef _MY_STRING_
 #define _MY_STRING_
 
+#include <inttypes.h>
 #include "../List/List.h"
 
 /* Opaque types */
 typedef struct String String;
+typedef struct StringNeedle StringNeedle;
 
 /* Types */
 typedef struct StringIterator {
@@ -24,14 +26,31 @@ char* String_clone_data(const String* this);
 int String_append_str(String* this, const String* str);
 int String_append_c_str(String* this, const char* c_str);
 int String_append_char(String* this, char c);
+int String_append_n(String* this, const char* ptr, unsigned int len);
+int String_append_many(String* this, const char* const* parts, const unsigned int* lens, unsigned int count);
+int String_reserve(String* this, unsigned int capacity);
 String* String_substring(const String* this, unsigned int start, unsigned int end);
 unsigned int String_len(const String* this);
 int String_is_equal(const String* str1, const String* str2);
 int String_is_equal_c_str(const String* this, const char* c_str);
+unsigned int String_hash(const String* this);
 int String_find(const String* haystack, const String* needle, unsigned int occurrence);
 int String_find_c_str(const String* haystack, const char* needle, unsigned int occurrence);
 void String_shrink_to_fit(String* this);
 List* String_split(String* this, const char* delim);
+/* find_all returns the offsets of every match, overlapping ones included, in a malloc'd array
+ * (NULL on failure). A StringNeedle is a copy of the needle prepared for repeated searches. */
+unsigned int* String_find_all(const String* haystack, const char* needle, unsigned int* count_out);
+int String_find_needle(const String* haystack, const StringNeedle* needle, unsigned int occurrence);
+unsigned int* String_find_all_needle(const String* haystack, const StringNeedle* needle, unsigned int* count_out);
+/* The same search on a plain buffer, for callers without a String (StringView). Returns -1 if not found. */
+int64_t String_find_n(const char* haystack, uint64_t haystack_len, const char* needle, uint64_t needle_len);
+
+/* StringNeedle methods */
+StringNeedle* StringNeedle_new(const char* c_str);
+StringNeedle* StringNeedle_new_str(const String* str);
+void StringNeedle_destroy(StringNeedle* this);
+unsigned int StringNeedle_len(const StringNeedle* this);
 
 
 /* StringIterator methods */
@@ -0,0 +1,26 @@
+#ifndef _MY_STRING_HASH_
+#define _MY_STRING_HASH_
+#include <inttypes.h>
+
+/* The one string hash behind String_hash, Intern_hash and HashTable's default hash function.
+ * They have to agree: HashTable's _str methods compare String_hash with the hash stored in the
+ * interned key. Bytes are added as char, so on signed char targets bytes past 127 count as
+ * negative, as they always have. */
+#define STRING_HASH_MULTIPLIER 65599
+
+static inline uint32_t string_hash_n(const char* ptr, uint32_t length){
+    uint32_t hash_value = 0;
+    for(uint32_t i=0; i<length; i++)
+        hash_value = hash_value * STRING_HASH_MULTIPLIER + ptr[i];
+    return hash_value;
+}
+
+static inline uint32_t string_hash_c_str(const char* c_str){
+    uint32_t hash_value = 0;
+    while(*c_str)
+        hash_value = hash_value * STRING_HASH_MULTIPLIER + *c_str++;
+    return hash_value;
+}
+
+
+#endif
@@ -0,0 +1,171 @@
+#include "StringView.h"
+#include <string.h>
+#include <ctype.h>
+#include <limits.h>
+
+/* StringView methods */
+StringView StringView_new(const char* ptr, uint64_t len){
+    return (StringView) {
+        .ptr = ptr,
+        .len = len
+    };
+}
+
+StringView StringView_from_c_str(const char* c_str){
+    return StringView_new(c_str, strlen(c_str));
+}
+
+StringView StringView_from_str(const String* str){
+    return StringView_new(String_data(str), String_len(str));
+}
+
+/* Returns NULL if the view doesn't fit in a String */
+String* StringView_to_str(StringView this){
+    if(this.len >= UINT_MAX)
+        return NULL;
+    String* str = String_new_reserve(this.len);
+    if(!str)
+        return NULL;
+    String_append_n(str, this.ptr, this.len);
+    return str;
+}
+
+/* start and len are clamped to the view */
+StringView StringView_substr(StringView this, uint64_t start, uint64_t len){
+    if(start > this.len)
+        start = this.len;
+    if(len > this.len - start)
+        len = this.len - start;
+    return StringView_new(this.ptr + start, len);
+}
+
+int StringView_compare(StringView a, StringView b){
+    uint64_t min_len = a.len < b.len ? a.len : b.len;
+    int cmp = min_len ? memcmp(a.ptr, b.ptr, min_len) : 0;
+    if(cmp != 0)
+        return cmp;
+    return (a.len > b.len) - (a.len < b.len);
+}
+
+bool StringView_is_equal(StringView a, StringView b){
+    return a.len == b.len && (a.len == 0 || memcmp(a.ptr, b.ptr, a.len) == 0);
+}
+
+bool StringView_is_equal_c_str(StringView this, const char* c_str){
+    return StringView_is_equal(this, StringView_from_c_str(c_str));
+}
+
+bool StringView_starts_with(StringView this, StringView prefix){
+    return prefix.len <= this.len && StringView_is_equal(StringView_new(this.ptr, prefix.len), prefix);
+}
+
+bool StringView_ends_with(StringView this, StringView suffix){
+    return suffix.len <= this.len && StringView_is_equal(StringView_new(this.ptr + this.len - suffix.len, suffix.len), suffix);
+}
+
+/* Returns the offset of the first match, or -1. Uses String's substring search. */
+int64_t StringView_find(StringView haystack, StringView needle){
+    return String_find_n(haystack.ptr, haystack.len, needle.ptr, needle.len);
+}
+
+int64_t StringView_find_char(StringView this, char c){
+    if(this.len == 0)
+        return -1;
+    const char* ptr = memchr(this.ptr, c, this.len);
+    return ptr ? ptr - this.ptr : -1;
+}
+
+StringView StringView_trim_left(StringView this){
+    while(this.len > 0 && isspace((unsigned char)this.ptr[0])){
+        this.ptr++;
+        this.len--;
+    }
+    return this;
+}
+
+StringView StringView_trim_right(StringView this){
+    while(this.len > 0 && isspace((unsigned char)this.ptr[this.len - 1]))
+        this.len--;
+    return this;
+}
+
+StringView StringView_trim(StringView this){
+    return StringView_trim_right(StringView_trim_left(this));
+}
+
+int StringView_parse_int(StringView this, int64_t* value_out){
+    uint64_t idx = 0;
+    bool negative = false;
+    if(this.len > 0 && (this.ptr[0] == '-' || this.ptr[0] == '+'))
+        negative = this.ptr[idx++] == '-';
+    if(idx == this.len)
+        return -1;
+    uint64_t limit = negative ? (uint64_t)INT64_MAX + 1 : (uint64_t)INT64_MAX;
+    uint64_t magnitude = 0;
+    for(; idx<this.len; idx++){
+        unsigned int digit = (unsigned char)this.ptr[idx] - '0';
+        if(digit > 9)
+            return -1;
+        if(magnitude > (limit - digit) / 10)
+            return -1;
+        magnitude = magnitude * 10 + digit;
+    }
+    *value_out = negative ? (int64_t)(0 - magnitude) : (int64_t)magnitude;
+    return 0;
+}
+
+/* SVSplitIterator */
+SVSplitIterator SVSplitIterator_new(StringView str, StringView delim){
+    return (SVSplitIterator) {
+        .rest = str,
+        .delim = delim,
+        .done = false
+    };
+}
+
+StringView* SVSplitIterator_next(SVSplitIterator* this){
+    if(this->done)
+        return NULL;
+    int64_t offset = this->delim.len ? StringView_find(this->rest, this->delim) : -1;
+    if(offset < 0){
+        this->piece = this->rest;
+        this->done = true;
+    }
+    else {
+        this->piece = StringView_new(this->rest.ptr, offset);
+        this->rest = StringView_substr(this->rest, offset + this->delim.len, this->rest.len);
+    }
+    return &this->piece;
+}
+
+/* SVTokenIterator */
+static inline bool is_delim(const SVTokenIterator* this, unsigned char c){
+    return (this->delims[c >> 6] >> (c & 63)) & 1;
+}
+
+SVTokenIterator SVTokenIterator_new(StringView str, const char* delims){
+    SVTokenIterator iter = {
+        .rest = str,
+        .delims = {0}
+    };
+    for(const unsigned char* c = (const unsigned char*)delims; *c; c++)
+        iter.delims[*c >> 6] |= 1ull << (*c & 63);
+    return iter;
+}
+
+StringView* SVTokenIterator_next(SVTokenIterator* this){
+    const char* ptr = this->rest.ptr;
+    const char* end = this->rest.ptr + this->rest.len;
+    while(ptr < end && is_delim(this, *ptr))
+        ptr++;
+    if(ptr == end){
+        this->rest = StringView_new(end, 0);
+        return NULL;
+    }
+    const char* token_end = ptr;
+    while(token_end < end && !is_delim(this, *token_end))
+        token_end++;
+    this->token = StringView_new(ptr, token_end - ptr);
+    this->rest = StringView_new(token_end, end - token_end);
+    return &this->token;
+}
@@ -0,0 +1,69 @@
+#ifndef _MY_STRING_VIEW_
+#define _MY_STRING_VIEW_
+#include <inttypes.h>
+#include <stdbool.h>
+#include "String.h"
+
+#define _MERGE_(prefix, num) prefix##num
+#define _LABEL_(num) _MERGE_(_uniq_, num)
+#define _UNIQUE_ID_ _LABEL_(__COUNTER__)
+
+/* Types */
+/* A view doesn't own its bytes and isn't null terminated: it is valid as long as the buffer
+ * it points into is. Views are small and passed by value. */
+typedef struct StringView {
+    const char* ptr;
+    uint64_t len;
+} StringView;
+
+typedef struct SVSplitIterator {
+    StringView rest;
+    StringView delim;
+    bool done;
+    StringView piece;
+} SVSplitIterator;
+
+typedef struct SVTokenIterator {
+    StringView rest;
+    uint64_t delims[4];     /* bitmap of delimiter bytes */
+    StringView token;
+} SVTokenIterator;
+
+/* StringView methods */
+StringView StringView_new(const char* ptr, uint64_t len);
+StringView StringView_from_c_str(const char* c_str);
+StringView StringView_from_str(const String* str);
+String* StringView_to_str(StringView this);
+StringView StringView_substr(StringView this, uint64_t start, uint64_t len);
+int StringView_compare(StringView a, StringView b);
+bool StringView_is_equal(StringView a, StringView b);
+bool StringView_is_equal_c_str(StringView this, const char* c_str);
+bool StringView_starts_with(StringView this, StringView prefix);
+bool StringView_ends_with(StringView this, StringView suffix);
+int64_t StringView_find(StringView haystack, StringView needle);
+int64_t StringView_find_char(StringView this, char c);
+StringView StringView_trim(StringView this);
+StringView StringView_trim_left(StringView this);
+StringView StringView_trim_right(StringView this);
+/* Parses an optionally signed decimal integer that spans the whole view.
+ * Returns -1 on an empty view, a stray character or overflow. */
+int StringView_parse_int(StringView this, int64_t* value_out);
+
+/* SVSplitIterator methods + macro
+ * Yields the pieces between occurrences of delim, empty ones included, like String_split. */
+SVSplitIterator SVSplitIterator_new(StringView str, StringView delim);
+StringView* SVSplitIterator_next(SVSplitIterator* this);
+
+#define _SVSplit_for_(_it, _str, _delim, _piece) for (SVSplitIterator _it = SVSplitIterator_new(_str, _delim); (_piece = SVSplitIterator_next(&_it)) != NULL; )
+#define SVSplit_for(str, delim, piece) _SVSplit_for_(_UNIQUE_ID_, str, delim, piece)
+
+/* SVTokenIterator methods + macro
+ * Yields the non empty runs of bytes that are not in delims, like strtok. */
+SVTokenIterator SVTokenIterator_new(StringView str, const char* delims);
+StringView* SVTokenIterator_next(SVTokenIterator* this);
+
+#define _SVToken_for_(_it, _str, _delims, _token) for (SVTokenIterator _it = SVTokenIterator_new(_str, _delims); (_token = SVTokenIterator_next(&_it)) != NULL; )
+#define SVToken_for(str, delims, token) _SVToken_for_(_UNIQUE_ID_, str, delims, token)
+
+
+#endif
@@ -0,0 +1,37 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "MappedVector.h"
+
+typedef struct Sample {
+    uint64_t id;
+    double reading;
+} Sample;
+
+const char* PATH = "samples.vec";
+
+int main() {
+    unlink(PATH);
+    MappedVector* samples = MappedVector_open(PATH, sizeof(Sample));
+    for (uint64_t i = 0; i < 100000; i++) {
+        Sample sample = { .id = i, .reading = i * 0.25 };
+        MappedVector_pushback(samples, &sample);
+    }
+    printf("size: %lu, capacity: %lu\n", MappedVector_size(samples), MappedVector_capacity(samples));
+    MappedVector_close(samples);
+
+    // no deserialization, the file is mapped back as it is
+    samples = MappedVector_open(PATH, sizeof(Sample));
+    Sample* sample = MappedVector_get(samples, 4242);
+    printf("reopened size: %lu, sample 4242: %.2f\n", MappedVector_size(samples), sample->reading);
+
+    double sum = 0;
+    Sample* data = MappedVector_data(samples);
+    for (uint64_t i = 0; i < MappedVector_size(samples); i++)
+        sum += data[i].reading;
+    printf("sum: %.1f\n", sum);
+
+    MappedVector_close(samples);
+    unlink(PATH);
+    return 0;
+}
@@ -0,0 +1,52 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "Vector.h"
+
+typedef struct Record {
+    double value;
+    uint64_t word_count;
+} Record;
+
+void transform(void* item) {
+    Record* record = item;
+    record->value = sqrt(record->value) * 2.0;
+}
+
+// reduce over uintptr_t values carried in the pointers
+void* word_count(void* item) {
+    return (void*)(uintptr_t)((Record*)item)->word_count;
+}
+
+void* add(void* acc, void* value) {
+    return (void*)((uintptr_t)acc + (uintptr_t)value);
+}
+
+void* max_record(void* acc, void* value) {
+    if (acc == NULL || ((Record*)value)->value > ((Record*)acc)->value)
+        return value;
+    return acc;
+}
+
+int main() {
+    const uint64_t count = 1000000;
+    Record* records = malloc(count * sizeof(Record));
+    Vector* vec = Vector_new_init_size(count);
+    for (uint64_t i = 0; i < count; i++) {
+        records[i] = (Record) { .value = i, .word_count = i % 7 };
+        Vector_pushback(vec, &records[i]);
+    }
+
+    Vector_apply_parallel(vec, transform, 4, 0);
+    printf("records[10000].value: %.1f\n", records[10000].value);
+
+    uintptr_t words = (uintptr_t)Vector_reduce_parallel(vec, word_count, add, (void*)0, 4);
+    printf("total words: %lu\n", words);
+
+    Record* max = Vector_reduce_parallel(vec, NULL, max_record, NULL, 4);
+    printf("max value: %.1f\n", max->value);
+
+    Vector_destroy(vec);
+    free(records);
+    return 0;
+}
@@ -0,0 +1,37 @@
+#include <stdio.h>
+#include "SegmentedVector.h"
+
+typedef struct Order {
+    uint64_t id;
+    double price;
+} Order;
+
+double total = 0;
+
+void add_price(void* order) {
+    total += ((Order*)order)->price;
+}
+
+int main() {
+    SegmentedVector* orders = SegmentedVector_new(sizeof(Order));
+
+    Order first = { .id = 0, .price = 9.99 };
+    Order* first_ref = SegmentedVector_pushback(orders, &first);
+    for (uint64_t i = 1; i < 1000000; i++) {
+        Order order = { .id = i, .price = (i % 100) * 0.5 };
+        SegmentedVector_pushback(orders, &order);
+    }
+
+    // the vector grew a million times over, but the first element never moved
+    printf("first still at %p: %s\n", (void*)first_ref, first_ref == SegmentedVector_get(orders, 0) ? "yes" : "no");
+    printf("size: %lu, capacity: %lu\n", SegmentedVector_size(orders), SegmentedVector_capacity(orders));
+
+    Order* order = SegmentedVector_get(orders, 123456);
+    printf("order %lu: %.2f\n", order->id, order->price);
+
+    SegmentedVector_apply(orders, add_price);
+    printf("total: %.2f\n", total);
+
+    SegmentedVector_destroy(orders);
+    return 0;
+}
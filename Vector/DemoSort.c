@@ -0,0 +1,58 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "Vector.h"
+
+typedef struct Event {
+    uint64_t timestamp;
+    char name[16];
+} Event;
+
+int cmp_events(const void* a, const void* b) {
+    const Event* x = a;
+    const Event* y = b;
+    return (x->timestamp > y->timestamp) - (x->timestamp < y->timestamp);
+}
+
+uint64_t event_timestamp(const void* event) {
+    return ((const Event*)event)->timestamp;
+}
+
+const char* event_name(const void* event) {
+    return ((const Event*)event)->name;
+}
+
+void print_head(const char* title, Vector* vec) {
+    printf("%s:", title);
+    for (uint64_t i = 0; i < 5; i++) {
+        Event* event = Vector_get(vec, i);
+        printf(" %s@%lu", event->name, event->timestamp);
+    }
+    puts("");
+}
+
+int main() {
+    const uint64_t count = 100000;
+    Event* events = malloc(count * sizeof(Event));
+    Vector* vec = Vector_new_init_size(count);
+    for (uint64_t i = 0; i < count; i++) {
+        events[i].timestamp = rand() % 1000000;
+        sprintf(events[i].name, "ev%d", rand() % 5000);
+        Vector_pushback(vec, &events[i]);
+    }
+
+    Vector_sort(vec, cmp_events);
+    print_head("pdqsort by time", vec);
+
+    Vector_radix_sort_by_str_key(vec, event_name);
+    print_head("radix by name", vec);
+
+    Vector_sort_parallel(vec, cmp_events, 4);
+    print_head("parallel by time", vec);
+
+    Vector_radix_sort_by_key(vec, event_timestamp);
+    print_head("radix by time", vec);
+
+    Vector_destroy(vec);
+    free(events);
+    return 0;
+}
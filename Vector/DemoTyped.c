@@ -0,0 +1,42 @@
+#include <stdio.h>
+#include "TypedVector.h"
+
+VECTOR_DEFINE(DoubleVector, double)
+
+typedef struct Point {
+    int x, y;
+} Point;
+
+VECTOR_DEFINE(PointVector, Point)
+
+void scale(double* item) {
+    *item *= 0.5;
+}
+
+int main() {
+    DoubleVector* vec = DoubleVector_new();
+    for (int i = 0; i < 100; i++)
+        DoubleVector_pushback(vec, i);     // 0 is a valid element
+
+    DoubleVector_apply(vec, scale);
+    double sum = 0, *item;
+    TV_for(vec, item)
+        sum += *item;
+    printf("size: %lu, capacity: %lu, sum: %.1f\n", DoubleVector_size(vec), DoubleVector_capacity(vec), sum);
+
+    double last;
+    DoubleVector_pop_back(vec, &last);
+    printf("popped: %.1f, front: %.1f, back: %.1f\n", last, *DoubleVector_front(vec), *DoubleVector_back(vec));
+    DoubleVector_destroy(vec);
+
+    PointVector* points = PointVector_new_init_size(4);
+    for (int i = 0; i < 5; i++)
+        PointVector_pushback(points, (Point) { .x = i, .y = i * i });
+    PointVector_set(points, 0, (Point) { .x = -1, .y = -1 });
+    Point* p;
+    TV_for(points, p)
+        printf("(%d, %d) ", p->x, p->y);
+    puts("");
+    PointVector_destroy(points);
+    return 0;
+}
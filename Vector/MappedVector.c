@@ -0,0 +1,186 @@
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "MappedVector.h"
+
+static const char MAGIC[8] = "CUVMAP01";
+static const uint64_t DEF_MAPPED_SIZE = 1024;
+
+/* Lives at the start of the file, the elements follow it */
+typedef struct MappedHeader {
+    char magic[8];
+    uint64_t element_size;
+    uint64_t element_count;
+    uint64_t capacity;
+    char reserved[32];
+} MappedHeader;
+
+struct MappedVector {
+    int fd;
+    MappedHeader* header;   /* start of the mapping */
+    char* data;
+    uint64_t mapped_bytes;
+};
+
+static inline uint64_t file_bytes(uint64_t element_size, uint64_t capacity) {
+    return sizeof(MappedHeader) + element_size * capacity;
+}
+
+static int MappedVector_map(MappedVector* this, uint64_t bytes) {
+    void* mapping;
+#ifdef __linux__
+    if (this->header)
+        mapping = mremap(this->header, this->mapped_bytes, bytes, MREMAP_MAYMOVE);
+    else
+#endif
+    {
+        if (this->header)
+            munmap(this->header, this->mapped_bytes);
+        mapping = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, this->fd, 0);
+    }
+    if (mapping == MAP_FAILED) {
+#ifndef __linux__
+        this->header = NULL;
+#endif
+        return -1;
+    }
+    this->header = mapping;
+    this->data = (char*)mapping + sizeof(MappedHeader);
+    this->mapped_bytes = bytes;
+    return 0;
+}
+
+static int MappedVector_create_file(MappedVector* this, uint64_t element_size) {
+    if (element_size == 0)
+        return -1;
+    uint64_t bytes = file_bytes(element_size, DEF_MAPPED_SIZE);
+    if (ftruncate(this->fd, bytes) == -1 || MappedVector_map(this, bytes) == -1)
+        return -1;
+    memcpy(this->header->magic, MAGIC, sizeof(MAGIC));
+    this->header->element_size = element_size;
+    this->header->element_count = 0;
+    this->header->capacity = DEF_MAPPED_SIZE;
+    return 0;
+}
+
+static int MappedVector_map_file(MappedVector* this, uint64_t element_size, uint64_t size) {
+    if (size < sizeof(MappedHeader) || MappedVector_map(this, size) == -1)
+        return -1;
+    MappedHeader* header = this->header;
+    if (memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0
+        || (element_size != 0 && header->element_size != element_size)
+        || file_bytes(header->element_size, header->capacity) > size
+        || header->element_count > header->capacity)
+        return -1;
+    return 0;
+}
+
+/* Creates or reopens the file at path. A new file is created for element_size bytes elements,
+ * an existing one must have been created with the same element_size (or pass 0 to accept it). */
+MappedVector* MappedVector_open(const char* path, uint64_t element_size) {
+    MappedVector* this = malloc(sizeof(MappedVector));
+    if (!this)
+        return NULL;
+    this->header = NULL;
+    this->fd = open(path, O_RDWR | O_CREAT, 0644);
+    struct stat st;
+    int status = -1;
+    if (this->fd != -1 && fstat(this->fd, &st) != -1) {
+        if (st.st_size == 0)
+            status = MappedVector_create_file(this, element_size);
+        else
+            status = MappedVector_map_file(this, element_size, st.st_size);
+    }
+    if (status == -1) {
+        if (this->header)
+            munmap(this->header, this->mapped_bytes);
+        if (this->fd != -1)
+            close(this->fd);
+        free(this);
+        return NULL;
+    }
+    return this;
+}
+
+void MappedVector_close(MappedVector* this) {
+    munmap(this->header, this->mapped_bytes);
+    close(this->fd);
+    free(this);
+}
+
+/* Blocks until the contents are on disk. Without it, the page cache writes them back eventually. */
+int MappedVector_sync(MappedVector* this) {
+    return msync(this->header, this->mapped_bytes, MS_SYNC);
+}
+
+uint64_t MappedVector_size(MappedVector* this) {
+    return this->header->element_count;
+}
+
+uint64_t MappedVector_capacity(MappedVector* this) {
+    return this->header->capacity;
+}
+
+uint64_t MappedVector_element_size(MappedVector* this) {
+    return this->header->element_size;
+}
+
+int MappedVector_reserve(MappedVector* this, uint64_t capacity) {
+    if (capacity <= this->header->capacity)
+        return 0;
+    uint64_t bytes = file_bytes(this->header->element_size, capacity);
+    if (ftruncate(this->fd, bytes) == -1)
+        return -1;
+    if (MappedVector_map(this, bytes) == -1)
+        return -1;
+    this->header->capacity = capacity;
+    return 0;
+}
+
+void MappedVector_clear(MappedVector* this) {
+    this->header->element_count = 0;
+}
+
+int MappedVector_pushback(MappedVector* this, const void* element) {
+    MappedHeader* header = this->header;
+    if (header->element_count == header->capacity)
+        if (MappedVector_reserve(this, header->capacity ? header->capacity * 2 : DEF_MAPPED_SIZE) == -1)
+            return -1;
+    header = this->header;
+    memcpy(this->data + header->element_count * header->element_size, element, header->element_size);
+    header->element_count++;
+    return 0;
+}
+
+int MappedVector_pop_back(MappedVector* this, void* element_out) {
+    MappedHeader* header = this->header;
+    if (header->element_count == 0)
+        return -1;
+    header->element_count--;
+    if (element_out)
+        memcpy(element_out, this->data + header->element_count * header->element_size, header->element_size);
+    return 0;
+}
+
+void* MappedVector_get(MappedVector* this, uint64_t idx) {
+    if (idx >= this->header->element_count)
+        return NULL;
+    return this->data + idx * this->header->element_size;
+}
+
+int MappedVector_set(MappedVector* this, uint64_t idx, const void* element) {
+    if (idx > this->header->element_count)
+        return -1;
+    else if (idx == this->header->element_count)
+        return MappedVector_pushback(this, element);
+    memcpy(this->data + idx * this->header->element_size, element, this->header->element_size);
+    return 0;
+}
+
+void* MappedVector_data(MappedVector* this) {
+    return this->data;
+}
@@ -0,0 +1,28 @@
+#ifndef _mapped_vec_
+#define _mapped_vec_
+
+#include <inttypes.h>
+
+/* Opaque types */
+typedef struct MappedVector MappedVector;
+
+/* MappedVector methods
+ * A vector of fixed size elements stored in a memory mapped file. Every change is a write to
+ * the mapping, so the contents persist without serializing and reopening is O(1).
+ * Growing remaps the file: pointers returned by get/data are invalidated by pushback/reserve. */
+MappedVector* MappedVector_open(const char* path, uint64_t element_size);
+void MappedVector_close(MappedVector* this);
+int MappedVector_sync(MappedVector* this);
+uint64_t MappedVector_size(MappedVector* this);
+uint64_t MappedVector_capacity(MappedVector* this);
+uint64_t MappedVector_element_size(MappedVector* this);
+int MappedVector_reserve(MappedVector* this, uint64_t capacity);
+void MappedVector_clear(MappedVector* this);
+int MappedVector_pushback(MappedVector* this, const void* element);
+int MappedVector_pop_back(MappedVector* this, void* element_out);
+void* MappedVector_get(MappedVector* this, uint64_t idx);
+int MappedVector_set(MappedVector* this, uint64_t idx, const void* element);
+void* MappedVector_data(MappedVector* this);
+
+
+#endif
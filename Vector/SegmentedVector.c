@@ -0,0 +1,129 @@
+#include <stdlib.h>
+#include <string.h>
+#include "SegmentedVector.h"
+
+/* Chunk k holds FIRST_CHUNK << k elements, so element i lives in chunk
+ * msb(i + FIRST_CHUNK) - FIRST_CHUNK_BITS, at offset (i + FIRST_CHUNK) - (FIRST_CHUNK << k).
+ * 64 - FIRST_CHUNK_BITS chunks cover the whole uint64_t index space, so the
+ * directory is a fixed array and never has to grow either. */
+#define FIRST_CHUNK_BITS 4
+#define FIRST_CHUNK (1ULL << FIRST_CHUNK_BITS)
+#define MAX_CHUNKS (64 - FIRST_CHUNK_BITS)
+
+struct SegmentedVector {
+    uint64_t element_size;
+    uint64_t element_count;
+    uint32_t chunk_count;
+    char* chunks[MAX_CHUNKS];
+};
+
+static inline uint32_t chunk_of(uint64_t idx) {
+    return (63 - __builtin_clzll(idx + FIRST_CHUNK)) - FIRST_CHUNK_BITS;
+}
+
+static inline uint64_t chunk_start(uint32_t chunk) {
+    return (FIRST_CHUNK << chunk) - FIRST_CHUNK;
+}
+
+static inline char* SegmentedVector_slot(SegmentedVector* this, uint64_t idx) {
+    uint32_t chunk = chunk_of(idx);
+    return this->chunks[chunk] + (idx - chunk_start(chunk)) * this->element_size;
+}
+
+SegmentedVector* SegmentedVector_new(uint64_t element_size) {
+    if (element_size == 0)
+        return NULL;
+    SegmentedVector* this = calloc(1, sizeof(SegmentedVector));
+    if (!this)
+        return NULL;
+    this->element_size = element_size;
+    return this;
+}
+
+void SegmentedVector_destroy(SegmentedVector* this) {
+    for (uint32_t i = 0; i < this->chunk_count; i++)
+        free(this->chunks[i]);
+    free(this);
+}
+
+uint64_t SegmentedVector_size(SegmentedVector* this) {
+    return this->element_count;
+}
+
+uint64_t SegmentedVector_capacity(SegmentedVector* this) {
+    return chunk_start(this->chunk_count);
+}
+
+uint64_t SegmentedVector_element_size(SegmentedVector* this) {
+    return this->element_size;
+}
+
+/* Keeps the chunks for reuse */
+void SegmentedVector_clear(SegmentedVector* this) {
+    this->element_count = 0;
+}
+
+static int SegmentedVector_add_chunk(SegmentedVector* this) {
+    if (this->chunk_count == MAX_CHUNKS)
+        return -1;
+    char* chunk = malloc((FIRST_CHUNK << this->chunk_count) * this->element_size);
+    if (!chunk)
+        return -1;
+    this->chunks[this->chunk_count++] = chunk;
+    return 0;
+}
+
+int SegmentedVector_reserve(SegmentedVector* this, uint64_t capacity) {
+    while (SegmentedVector_capacity(this) < capacity)
+        if (SegmentedVector_add_chunk(this) == -1)
+            return -1;
+    return 0;
+}
+
+/* Returns the address of the new element, or NULL if out of memory */
+void* SegmentedVector_pushback(SegmentedVector* this, const void* element) {
+    if (this->element_count == SegmentedVector_capacity(this))
+        if (SegmentedVector_add_chunk(this) == -1)
+            return NULL;
+    char* slot = SegmentedVector_slot(this, this->element_count++);
+    memcpy(slot, element, this->element_size);
+    return slot;
+}
+
+int SegmentedVector_pop_back(SegmentedVector* this, void* element_out) {
+    if (this->element_count == 0)
+        return -1;
+    this->element_count--;
+    if (element_out)
+        memcpy(element_out, SegmentedVector_slot(this, this->element_count), this->element_size);
+    return 0;
+}
+
+void* SegmentedVector_get(SegmentedVector* this, uint64_t idx) {
+    if (idx >= this->element_count)
+        return NULL;
+    return SegmentedVector_slot(this, idx);
+}
+
+int SegmentedVector_set(SegmentedVector* this, uint64_t idx, const void* element) {
+    if (idx > this->element_count)
+        return -1;
+    else if (idx == this->element_count)
+        return SegmentedVector_pushback(this, element) ? 0 : -1;
+    memcpy(SegmentedVector_slot(this, idx), element, this->element_size);
+    return 0;
+}
+
+/* Walks chunk by chunk instead of decoding every index */
+void SegmentedVector_apply(SegmentedVector* this, void (*func)(void *)) {
+    uint64_t remaining = this->element_count;
+    for (uint32_t chunk = 0; remaining > 0; chunk++) {
+        uint64_t count = FIRST_CHUNK << chunk;
+        if (count > remaining)
+            count = remaining;
+        char* slot = this->chunks[chunk];
+        for (uint64_t i = 0; i < count; i++, slot += this->element_size)
+            func(slot);
+        remaining -= count;
+    }
+}
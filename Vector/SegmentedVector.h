@@ -0,0 +1,27 @@
+#ifndef _segmented_vec_
+#define _segmented_vec_
+
+#include <inttypes.h>
+
+/* Opaque types */
+typedef struct SegmentedVector SegmentedVector;
+
+/* SegmentedVector methods
+ * A vector of fixed size elements stored in chunks of doubling size. Growing only allocates the
+ * next chunk, so elements never move: pointers returned by get/pushback stay valid until the
+ * element is popped or the vector cleared/destroyed. */
+SegmentedVector* SegmentedVector_new(uint64_t element_size);
+void SegmentedVector_destroy(SegmentedVector* this);
+uint64_t SegmentedVector_size(SegmentedVector* this);
+uint64_t SegmentedVector_capacity(SegmentedVector* this);
+uint64_t SegmentedVector_element_size(SegmentedVector* this);
+void SegmentedVector_clear(SegmentedVector* this);
+int SegmentedVector_reserve(SegmentedVector* this, uint64_t capacity);
+void* SegmentedVector_pushback(SegmentedVector* this, const void* element);
+int SegmentedVector_pop_back(SegmentedVector* this, void* element_out);
+void* SegmentedVector_get(SegmentedVector* this, uint64_t idx);
+int SegmentedVector_set(SegmentedVector* this, uint64_t idx, const void* element);
+void SegmentedVector_apply(SegmentedVector* this, void (*func)(void *));
+
+
+#endif
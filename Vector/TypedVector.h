@@ -0,0 +1,150 @@
+#ifndef _typed_vec_
+#define _typed_vec_
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* VECTOR_DEFINE(name, T) generates a vector type `name` that stores T values inline
+ * (no boxing, no NULL restriction) and its methods, all prefixed with `name_`:
+ *
+ *     name* name_new(void);
+ *     name* name_new_init_size(uint64_t size);
+ *     void name_destroy(name* this);
+ *     uint64_t name_size(const name* this);
+ *     uint64_t name_capacity(const name* this);
+ *     void name_clear(name* this);
+ *     int name_reserve(name* this, uint64_t capacity);
+ *     int name_pushback(name* this, T value);
+ *     int name_pop_back(name* this, T* out);
+ *     T name_get(const name* this, uint64_t idx);          unchecked
+ *     T* name_at(const name* this, uint64_t idx);          NULL if out of range
+ *     int name_set(name* this, uint64_t idx, T value);
+ *     T* name_data(const name* this);
+ *     T* name_front(const name* this);
+ *     T* name_back(const name* this);
+ *     void name_apply(name* this, void (*func)(T* ));
+ *
+ * The struct is public so that loops over name->data can be inlined and vectorized,
+ * TV_for(vec, ptr) iterates over pointers to the elements.
+ * Every method is static inline, so VECTOR_DEFINE can be used from a header. */
+
+#define TV_DEF_SIZE 16
+
+#define _VECTOR_STRUCT_(name, T) \
+typedef struct name { \
+    T* data; \
+    uint64_t size; \
+    uint64_t capacity; \
+} name;
+
+#define VECTOR_DEFINE(name, T) \
+_VECTOR_STRUCT_(name, T) \
+\
+static inline int name##_reserve(name* this, uint64_t capacity) { \
+    if (capacity <= this->capacity) \
+        return 0; \
+    T* new_data = realloc(this->data, capacity * sizeof(T)); \
+    if (!new_data) \
+        return -1; \
+    this->data = new_data; \
+    this->capacity = capacity; \
+    return 0; \
+} \
+\
+static inline name* name##_new_init_size(uint64_t size) { \
+    name* this = malloc(sizeof(name)); \
+    if (!this) \
+        return NULL; \
+    this->data = NULL; \
+    this->size = 0; \
+    this->capacity = 0; \
+    if (name##_reserve(this, size ? size : 1) == -1) { \
+        free(this); \
+        return NULL; \
+    } \
+    return this; \
+} \
+\
+static inline name* name##_new(void) { \
+    return name##_new_init_size(TV_DEF_SIZE); \
+} \
+\
+static inline void name##_destroy(name* this) { \
+    free(this->data); \
+    free(this); \
+} \
+\
+static inline uint64_t name##_size(const name* this) { \
+    return this->size; \
+} \
+\
+static inline uint64_t name##_capacity(const name* this) { \
+    return this->capacity; \
+} \
+\
+static inline void name##_clear(name* this) { \
+    this->size = 0; \
+} \
+\
+static inline int name##_pushback(name* this, T value) { \
+    if (this->size == this->capacity) \
+        if (name##_reserve(this, this->capacity * 2) == -1) \
+            return -1; \
+    this->data[this->size++] = value; \
+    return 0; \
+} \
+\
+static inline int name##_pop_back(name* this, T* out) { \
+    if (this->size == 0) \
+        return -1; \
+    this->size--; \
+    if (out) \
+        *out = this->data[this->size]; \
+    return 0; \
+} \
+\
+static inline T name##_get(const name* this, uint64_t idx) { \
+    return this->data[idx]; \
+} \
+\
+static inline T* name##_at(const name* this, uint64_t idx) { \
+    if (idx >= this->size) \
+        return NULL; \
+    return this->data + idx; \
+} \
+\
+static inline int name##_set(name* this, uint64_t idx, T value) { \
+    if (idx > this->size) \
+        return -1; \
+    else if (idx == this->size) \
+        return name##_pushback(this, value); \
+    this->data[idx] = value; \
+    return 0; \
+} \
+\
+static inline T* name##_data(const name* this) { \
+    return this->data; \
+} \
+\
+static inline T* name##_front(const name* this) { \
+    return name##_at(this, 0); \
+} \
+\
+static inline T* name##_back(const name* this) { \
+    if (this->size == 0) \
+        return NULL; \
+    return this->data + this->size - 1; \
+} \
+\
+static inline void name##_apply(name* this, void (*func)(T* )) { \
+    T* end = this->data + this->size; \
+    for (T* item = this->data; item != end; item++) \
+        func(item); \
+}
+
+#define TV_for(vec, ptr) for (ptr = (vec)->data; ptr != (vec)->data + (vec)->size; ptr++)
+
+
+#endif
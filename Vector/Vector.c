@@ -1,30 +1,114 @@
+#define _GNU_SOURCE
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
 #include <stdbool.h>
+#include <sys/mman.h>
 #include "Vector.h"
 
 const uint64_t DEF_SIZE = 50;
-const uint64_t EXPAND_RATE = 2;
+const double DEF_GROWTH_FACTOR = 2.0;
 const uint64_t RESERVE_EXP_LEN = 50;
+/* Tables at least this big get their own mapping, so growing them is an mremap
+ * (page table update) instead of a copy. The mapping is sized in huge pages and
+ * advised as huge page backed to cut TLB misses on billion element tables. */
+const uint64_t MAPPED_TABLE_BYTES = 1 << 26;
+const uint64_t HUGE_PAGE_BYTES = 1 << 21;
 
 struct Vector {
     void** table;
     uint64_t capacity;
     uint64_t element_count;
+    double growth_factor;
+    bool mapped;
 };
 
-static int Vector_expand(Vector* this) {
-    void** new_table = calloc(this->capacity * 2, sizeof(void*));
-    if(!new_table)
-        return -1;
-    memcpy(new_table, this->table, this->capacity * sizeof(void*));
-    free(this->table);
+static uint64_t huge_page_round_up(uint64_t bytes) {
+    return (bytes + HUGE_PAGE_BYTES - 1) & ~(HUGE_PAGE_BYTES - 1);
+}
+
+static void** map_table(void** old_table, uint64_t old_bytes, uint64_t new_bytes) {
+    void* new_table;
+#ifdef __linux__
+    if (old_table)
+        new_table = mremap(old_table, old_bytes, new_bytes, MREMAP_MAYMOVE);
+    else
+#endif
+        new_table = mmap(NULL, new_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (new_table == MAP_FAILED)
+        return NULL;
+#ifdef MADV_HUGEPAGE
+    madvise(new_table, new_bytes, MADV_HUGEPAGE);
+#endif
+#ifndef __linux__
+    if (old_table) {
+        memcpy(new_table, old_table, old_bytes < new_bytes ? old_bytes : new_bytes);
+        munmap(old_table, old_bytes);
+    }
+#endif
+    return new_table;
+}
+
+/* Moves the table to new_capacity slots (new_capacity >= element_count).
+ * Small tables use realloc, big ones are mapped and resized with mremap. */
+static int Vector_resize_table(Vector* this, uint64_t new_capacity) {
+    if (new_capacity == 0)
+        new_capacity = 1;
+    uint64_t new_bytes = new_capacity * sizeof(void*);
+    uint64_t used_bytes = this->element_count * sizeof(void*);
+    void** new_table;
+    if (new_bytes >= MAPPED_TABLE_BYTES) {
+        new_bytes = huge_page_round_up(new_bytes);
+        if (this->mapped)
+            new_table = map_table(this->table, this->capacity * sizeof(void*), new_bytes);
+        else {
+            new_table = map_table(NULL, 0, new_bytes);
+            if (new_table) {
+                memcpy(new_table, this->table, used_bytes);
+                free(this->table);
+            }
+        }
+        if (!new_table)
+            return -1;
+        this->mapped = true;
+        this->capacity = new_bytes / sizeof(void*);
+    }
+    else {
+        if (this->mapped) {
+            new_table = malloc(new_bytes);
+            if (new_table) {
+                memcpy(new_table, this->table, used_bytes);
+                munmap(this->table, this->capacity * sizeof(void*));
+            }
+        }
+        else
+            new_table = realloc(this->table, new_bytes);
+        if (!new_table)
+            return -1;
+        this->mapped = false;
+        this->capacity = new_capacity;
+    }
     this->table = new_table;
-    this->capacity *= 2;
     return 0;
 }
 
+static int Vector_expand(Vector* this) {
+    uint64_t new_capacity = this->capacity * this->growth_factor;
+    if (new_capacity <= this->capacity)
+        new_capacity = this->capacity + 1;
+    return Vector_resize_table(this, new_capacity);
+}
+
+/* Makes room for needed elements, growing geometrically so repeated appends stay amortized O(1) */
+static int Vector_ensure_capacity(Vector* this, uint64_t needed) {
+    if (needed <= this->capacity)
+        return 0;
+    uint64_t new_capacity = this->capacity * this->growth_factor;
+    if (new_capacity < needed)
+        new_capacity = needed;
+    return Vector_resize_table(this, new_capacity);
+}
+
 Vector* Vector_new(void) {
     return Vector_new_init_size(DEF_SIZE);
 }
@@ -33,10 +117,12 @@ Vector* Vector_new_init_size(uint64_t size) {
     Vector* this = malloc(sizeof(Vector));
     if(!this)
         return NULL;
-    this->capacity = size;
+    this->table = NULL;
+    this->capacity = 0;
     this->element_count = 0;
-    this->table = calloc(size, sizeof(void*));
-    if (this->table == NULL) {
+    this->growth_factor = DEF_GROWTH_FACTOR;
+    this->mapped = false;
+    if (Vector_resize_table(this, size) == -1) {
         free(this);
         return NULL;
     }
@@ -44,7 +130,10 @@ Vector* Vector_new_init_size(uint64_t size) {
 } 
 
 void Vector_destroy(Vector* this) {
-    free(this->table);
+    if (this->mapped)
+        munmap(this->table, this->capacity * sizeof(void*));
+    else
+        free(this->table);
     free(this);
 }
 
@@ -56,9 +145,31 @@ uint64_t Vector_capacity(Vector* this) {
     return this->capacity;
 }
 
+int Vector_reserve(Vector* this, uint64_t capacity) {
+    if (capacity <= this->capacity)
+        return 0;
+    return Vector_resize_table(this, capacity);
+}
+
+int Vector_shrink_to_fit(Vector* this) {
+    if (this->capacity == this->element_count)
+        return 0;
+    return Vector_resize_table(this, this->element_count);
+}
+
+int Vector_set_growth_factor(Vector* this, double growth_factor) {
+    if (growth_factor <= 1.0)
+        return -1;
+    this->growth_factor = growth_factor;
+    return 0;
+}
+
+double Vector_get_growth_factor(Vector* this) {
+    return this->growth_factor;
+}
+
+/* Slots past element_count are never read, so there is nothing to reset */
 void Vector_clear(Vector* this) {
-    for(int32_t idx = 0; idx < this->capacity; idx++)
-        this->table[idx] = NULL;
     this->element_count = 0;
 }
 
@@ -69,7 +180,7 @@ void** Vector_data(Vector* this) {
 int Vector_pushback(Vector* this, const void* data) {
     if(!data)
         return -2;
-    int32_t new_elem_idx = this->element_count;
+    uint64_t new_elem_idx = this->element_count;
     if(new_elem_idx >= this->capacity)
         if(Vector_expand(this) == -1)
             return -1;
@@ -89,6 +200,66 @@ int Vector_set(Vector* this, uint64_t idx, const void* data) {
     return 0;
 }
 
+int Vector_append_array(Vector* this, void* const* items, uint64_t count) {
+    return Vector_insert_range(this, this->element_count, items, count);
+}
+
+int Vector_append_vector(Vector* this, Vector* other) {
+    uint64_t count = other->element_count;
+    if (Vector_ensure_capacity(this, this->element_count + count) == -1)
+        return -1;
+    /* other->table is read after the resize, so appending a vector to itself works */
+    memcpy(this->table + this->element_count, other->table, count * sizeof(void*));
+    this->element_count += count;
+    return 0;
+}
+
+/* items may point into this vector. It is then found again by offset after the resize, and
+ * the items at or past idx are read from where the memmove shifted them. */
+int Vector_insert_range(Vector* this, uint64_t idx, void* const* items, uint64_t count) {
+    if (idx > this->element_count)
+        return -1;
+    uint64_t src = (uintptr_t)items - (uintptr_t)this->table;
+    bool owned = (uintptr_t)items >= (uintptr_t)this->table && src < this->capacity * sizeof(void*);
+    src /= sizeof(void*);
+    if (Vector_ensure_capacity(this, this->element_count + count) == -1)
+        return -1;
+    void** table = this->table;
+    memmove(table + idx + count, table + idx, (this->element_count - idx) * sizeof(void*));
+    if (owned) {
+        uint64_t before = src >= idx ? 0 : idx - src < count ? idx - src : count;
+        memcpy(table + idx, table + src, before * sizeof(void*));
+        memcpy(table + idx + before, table + src + before + count, (count - before) * sizeof(void*));
+    }
+    else
+        memcpy(table + idx, items, count * sizeof(void*));
+    this->element_count += count;
+    return 0;
+}
+
+int Vector_erase_range(Vector* this, uint64_t idx, uint64_t count) {
+    if (idx > this->element_count || count > this->element_count - idx)
+        return -1;
+    void** table = this->table;
+    memmove(table + idx, table + idx + count, (this->element_count - idx - count) * sizeof(void*));
+    this->element_count -= count;
+    return 0;
+}
+
+void* Vector_pop_back(Vector* this) {
+    if (this->element_count == 0)
+        return NULL;
+    return this->table[--this->element_count];
+}
+
+void* Vector_swap_remove(Vector* this, uint64_t idx) {
+    if (idx >= this->element_count)
+        return NULL;
+    void* removed = this->table[idx];
+    this->table[idx] = this->table[--this->element_count];
+    return removed;
+}
+
 void* Vector_get(Vector* this, uint64_t idx) {
     if(idx >= this->element_count)
         return NULL;
@@ -96,6 +267,8 @@ void* Vector_get(Vector* this, uint64_t idx) {
 }
 
 void* Vector_front(Vector* this) {
+    if (this->element_count == 0)
+        return NULL;
     return this->table[0];
 }
 
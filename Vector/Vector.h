@@ -15,7 +15,7 @@ typedef struct Vector Vector;
 /* Types */
 typedef struct VIterator {
     Vector* vector;
-    int32_t idx;
+    uint64_t idx;
 } VIterator;
 
 /* Vector methods */
@@ -24,13 +24,31 @@ Vector* Vector_new_init_size(uint64_t size);
 void Vector_destroy(Vector* this);
 uint64_t Vector_size(Vector* this);
 uint64_t Vector_capacity(Vector* this);
+int Vector_reserve(Vector* this, uint64_t capacity);
+int Vector_shrink_to_fit(Vector* this);
+int Vector_set_growth_factor(Vector* this, double growth_factor);
+double Vector_get_growth_factor(Vector* this);
 void Vector_clear(Vector* this);
+void** Vector_data(Vector* this);
 int Vector_pushback(Vector* this, const void* data);
 void* Vector_get(Vector* this, uint64_t index);
 int Vector_set(Vector* this, uint64_t idx, const void* data);
+/* Bulk operations don't check the items for NULL, the caller must not pass any */
+int Vector_append_array(Vector* this, void* const* items, uint64_t count);
+int Vector_append_vector(Vector* this, Vector* other);
+int Vector_insert_range(Vector* this, uint64_t idx, void* const* items, uint64_t count);
+int Vector_erase_range(Vector* this, uint64_t idx, uint64_t count);
+void* Vector_pop_back(Vector* this);
+void* Vector_swap_remove(Vector* this, uint64_t idx);
 void* Vector_front(Vector* this);
 void* Vector_back(Vector* this);
 void Vector_apply(Vector* this, void (*func)(void *));
+void Vector_apply_parallel(Vector* this, void (*func)(void *), uint32_t nthreads, uint64_t grain);
+void* Vector_reduce_parallel(Vector* this, void* (*map)(void* item), void* (*combine)(void* acc, void* value), void* identity, uint32_t nthreads);
+void Vector_sort(Vector* this, int (*cmp)(const void* a, const void* b));
+int Vector_sort_parallel(Vector* this, int (*cmp)(const void* a, const void* b), uint32_t nthreads);
+int Vector_radix_sort_by_key(Vector* this, uint64_t (*key)(const void* item));
+int Vector_radix_sort_by_str_key(Vector* this, const char* (*key)(const void* item));
 void Vector_serialize(Vector* this, FILE* fp, void (*item_serializer)(FILE* fp, void* item));
 Vector* Vector_deserialize(FILE* fp, void* (*item_deserializer)(FILE* fp));
 
@@ -38,6 +56,7 @@ Vector* Vector_deserialize(FILE* fp, void* (*item_deserializer)(FILE* fp));
 VIterator VIterator_new(Vector* vector);
 void* VIterator_peak(VIterator* this);
 void* VIterator_next(VIterator* this);
+void VIterator_reset(VIterator* this);
 
 #define _V_for_(_vec, _val, unique_id) for (VIterator unique_id = VIterator_new(_vec); (_val = VIterator_next(&unique_id)) != NULL; )
 #define V_for(vec, val) _V_for_(vec, val, _UNIQUE_ID_)
@@ -0,0 +1,128 @@
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "Vector.h"
+
+static const uint64_t CHUNKS_PER_THREAD = 8;
+
+/* Runs worker(args[i]) for every i, on nthreads - 1 new threads plus the caller.
+ * Work of threads that fail to start is done inline. */
+static void run_workers(void* (*worker)(void* ), void** args, uint32_t nthreads) {
+    pthread_t* threads = malloc(nthreads * sizeof(pthread_t));
+    bool* started = calloc(nthreads, sizeof(bool));
+    bool can_spawn = threads && started;
+    for (uint32_t i = 0; i < nthreads; i++) {
+        if (can_spawn && i + 1 < nthreads && pthread_create(&threads[i], NULL, worker, args[i]) == 0)
+            started[i] = true;
+        else
+            worker(args[i]);
+    }
+    for (uint32_t i = 0; can_spawn && i < nthreads; i++)
+        if (started[i])
+            pthread_join(threads[i], NULL);
+    free(threads);
+    free(started);
+}
+
+/* Vector_apply_parallel workers grab grain sized chunks off a shared counter,
+ * so uneven per item costs still keep every thread busy. */
+typedef struct ApplyTask {
+    void** table;
+    uint64_t size;
+    uint64_t grain;
+    atomic_uint_fast64_t next;
+    void (*func)(void* );
+} ApplyTask;
+
+static void* apply_worker(void* arg) {
+    ApplyTask* task = arg;
+    uint64_t begin;
+    while ((begin = atomic_fetch_add_explicit(&task->next, task->grain, memory_order_relaxed)) < task->size) {
+        uint64_t end = task->size - begin > task->grain ? begin + task->grain : task->size;
+        for (uint64_t i = begin; i < end; i++)
+            task->func(task->table[i]);
+    }
+    return NULL;
+}
+
+/* grain: items per chunk, 0 picks one that gives every thread several chunks */
+void Vector_apply_parallel(Vector* this, void (*func)(void *), uint32_t nthreads, uint64_t grain) {
+    uint64_t size = Vector_size(this);
+    if (nthreads == 0)
+        nthreads = 1;
+    if (grain == 0)
+        grain = size / ((uint64_t)nthreads * CHUNKS_PER_THREAD) + 1;
+    if (nthreads > size / grain + 1)
+        nthreads = size / grain + 1;
+
+    ApplyTask task = { .table = Vector_data(this), .size = size, .grain = grain, .func = func };
+    atomic_init(&task.next, 0);
+    void** args = malloc(nthreads * sizeof(void*));
+    if (!args) {
+        apply_worker(&task);
+        return;
+    }
+    for (uint32_t i = 0; i < nthreads; i++)
+        args[i] = &task;
+    run_workers(apply_worker, args, nthreads);
+    free(args);
+}
+
+/* Vector_reduce_parallel splits the items into nthreads fixed, contiguous chunks,
+ * folds each chunk left to right and then folds the partial results in chunk order.
+ * The grouping only depends on nthreads, so the result is the same on every run,
+ * and equal to the sequential fold whenever combine is associative. */
+typedef struct ReduceTask {
+    void** table;
+    uint64_t begin, end;
+    void* (*map)(void* );
+    void* (*combine)(void* , void* );
+    void* result;
+} ReduceTask;
+
+static void* reduce_worker(void* arg) {
+    ReduceTask* task = arg;
+    void* acc = task->result;
+    for (uint64_t i = task->begin; i < task->end; i++)
+        acc = task->combine(acc, task->map ? task->map(task->table[i]) : task->table[i]);
+    task->result = acc;
+    return NULL;
+}
+
+/* map may be NULL to combine the items themselves */
+void* Vector_reduce_parallel(Vector* this, void* (*map)(void* item), void* (*combine)(void* acc, void* value), void* identity, uint32_t nthreads) {
+    uint64_t size = Vector_size(this);
+    if (nthreads == 0)
+        nthreads = 1;
+    if (nthreads > size)
+        nthreads = size ? size : 1;
+
+    ReduceTask* tasks = malloc(nthreads * sizeof(ReduceTask));
+    void** args = malloc(nthreads * sizeof(void*));
+    if (!tasks || !args) {
+        free(tasks);
+        free(args);
+        ReduceTask task = { .table = Vector_data(this), .begin = 0, .end = size, .map = map, .combine = combine, .result = identity };
+        reduce_worker(&task);
+        return task.result;
+    }
+    for (uint32_t i = 0; i < nthreads; i++) {
+        tasks[i] = (ReduceTask) {
+            .table = Vector_data(this),
+            .begin = size * i / nthreads,
+            .end = size * (i + 1) / nthreads,
+            .map = map,
+            .combine = combine,
+            .result = identity
+        };
+        args[i] = &tasks[i];
+    }
+    run_workers(reduce_worker, args, nthreads);
+
+    void* result = tasks[0].result;
+    for (uint32_t i = 1; i < nthreads; i++)
+        result = combine(result, tasks[i].result);
+    free(tasks);
+    free(args);
+    return result;
+}
@@ -0,0 +1,469 @@
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include "Vector.h"
+
+typedef int (*cmp_fn)(const void* , const void* );
+
+#define LESS(a, b) (cmp((a), (b)) < 0)
+
+static const size_t INSERTION_SORT_THRESHOLD = 24;
+static const size_t NINTHER_THRESHOLD = 128;
+static const size_t PARTIAL_INSERTION_SORT_LIMIT = 8;
+static const size_t STR_INSERTION_SORT_THRESHOLD = 32;
+
+static inline void swap(void** a, void** b) {
+    void* tmp = *a;
+    *a = *b;
+    *b = tmp;
+}
+
+/* pdqsort (Orson Peters, "Pattern-defeating Quicksort", 2021) over an array of items.
+ * Quicksort with median of 3 / ninther pivots, that detects already partitioned and
+ * equal element runs, shuffles on bad partitions and falls back to heapsort. */
+
+static void insertion_sort(void** begin, void** end, cmp_fn cmp) {
+    if (begin == end)
+        return;
+    for (void** cur = begin + 1; cur != end; cur++) {
+        void** sift = cur;
+        void** sift_1 = cur - 1;
+        if (LESS(*sift, *sift_1)) {
+            void* tmp = *sift;
+            do {
+                *sift-- = *sift_1;
+            } while (sift != begin && LESS(tmp, *--sift_1));
+            *sift = tmp;
+        }
+    }
+}
+
+/* Same as insertion_sort, but *(begin - 1) must be <= every element of [begin, end) */
+static void unguarded_insertion_sort(void** begin, void** end, cmp_fn cmp) {
+    if (begin == end)
+        return;
+    for (void** cur = begin + 1; cur != end; cur++) {
+        void** sift = cur;
+        void** sift_1 = cur - 1;
+        if (LESS(*sift, *sift_1)) {
+            void* tmp = *sift;
+            do {
+                *sift-- = *sift_1;
+            } while (LESS(tmp, *--sift_1));
+            *sift = tmp;
+        }
+    }
+}
+
+/* Insertion sort that gives up after PARTIAL_INSERTION_SORT_LIMIT moves. Returns true if it sorted the range */
+static bool partial_insertion_sort(void** begin, void** end, cmp_fn cmp) {
+    if (begin == end)
+        return true;
+    size_t moves = 0;
+    for (void** cur = begin + 1; cur != end; cur++) {
+        void** sift = cur;
+        void** sift_1 = cur - 1;
+        if (LESS(*sift, *sift_1)) {
+            void* tmp = *sift;
+            do {
+                *sift-- = *sift_1;
+            } while (sift != begin && LESS(tmp, *--sift_1));
+            *sift = tmp;
+            moves += cur - sift;
+        }
+        if (moves > PARTIAL_INSERTION_SORT_LIMIT)
+            return false;
+    }
+    return true;
+}
+
+static inline void sort2(void** a, void** b, cmp_fn cmp) {
+    if (LESS(*b, *a))
+        swap(a, b);
+}
+
+static inline void sort3(void** a, void** b, void** c, cmp_fn cmp) {
+    sort2(a, b, cmp);
+    sort2(b, c, cmp);
+    sort2(a, b, cmp);
+}
+
+static void sift_down(void** heap, size_t size, size_t root, cmp_fn cmp) {
+    size_t child;
+    while ((child = 2 * root + 1) < size) {
+        if (child + 1 < size && LESS(heap[child], heap[child + 1]))
+            child++;
+        if (!LESS(heap[root], heap[child]))
+            return;
+        swap(heap + root, heap + child);
+        root = child;
+    }
+}
+
+static void heap_sort(void** begin, void** end, cmp_fn cmp) {
+    size_t size = end - begin;
+    for (size_t i = size / 2; i-- > 0; )
+        sift_down(begin, size, i, cmp);
+    while (size > 1) {
+        swap(begin, begin + --size);
+        sift_down(begin, size, 0, cmp);
+    }
+}
+
+/* Partitions [begin, end) around *begin, elements equal to the pivot go to the right.
+ * Returns the pivot's final position. */
+static void** partition_right(void** begin, void** end, cmp_fn cmp, bool* already_partitioned) {
+    void* pivot = *begin;
+    void** first = begin;
+    void** last = end;
+    /* the median of 3 guarantees an element >= pivot before end */
+    while (LESS(*++first, pivot));
+    if (first - 1 == begin)
+        while (first < last && !LESS(*--last, pivot));
+    else
+        while (!LESS(*--last, pivot));
+    *already_partitioned = first >= last;
+    while (first < last) {
+        swap(first, last);
+        while (LESS(*++first, pivot));
+        while (!LESS(*--last, pivot));
+    }
+    void** pivot_pos = first - 1;
+    *begin = *pivot_pos;
+    *pivot_pos = pivot;
+    return pivot_pos;
+}
+
+/* Partitions [begin, end) around *begin, elements equal to the pivot go to the left.
+ * Used when the pivot equals the element before the range, so the whole left side is done. */
+static void** partition_left(void** begin, void** end, cmp_fn cmp) {
+    void* pivot = *begin;
+    void** first = begin;
+    void** last = end;
+    while (LESS(pivot, *--last));
+    if (last + 1 == end)
+        while (first < last && !LESS(pivot, *++first));
+    else
+        while (!LESS(pivot, *++first));
+    while (first < last) {
+        swap(first, last);
+        while (LESS(pivot, *--last));
+        while (!LESS(pivot, *++first));
+    }
+    void** pivot_pos = last;
+    *begin = *pivot_pos;
+    *pivot_pos = pivot;
+    return pivot_pos;
+}
+
+static void pdqsort_loop(void** begin, void** end, cmp_fn cmp, int bad_allowed, bool leftmost) {
+    while (true) {
+        size_t size = end - begin;
+        if (size < INSERTION_SORT_THRESHOLD) {
+            if (leftmost)
+                insertion_sort(begin, end, cmp);
+            else
+                unguarded_insertion_sort(begin, end, cmp);
+            return;
+        }
+
+        size_t s2 = size / 2;
+        if (size > NINTHER_THRESHOLD) {
+            sort3(begin, begin + s2, end - 1, cmp);
+            sort3(begin + 1, begin + (s2 - 1), end - 2, cmp);
+            sort3(begin + 2, begin + (s2 + 1), end - 3, cmp);
+            sort3(begin + (s2 - 1), begin + s2, begin + (s2 + 1), cmp);
+            swap(begin, begin + s2);
+        }
+        else
+            sort3(begin + s2, begin, end - 1, cmp);
+
+        if (!leftmost && !LESS(*(begin - 1), *begin)) {
+            begin = partition_left(begin, end, cmp) + 1;
+            continue;
+        }
+
+        bool already_partitioned;
+        void** pivot_pos = partition_right(begin, end, cmp, &already_partitioned);
+        size_t l_size = pivot_pos - begin;
+        size_t r_size = end - (pivot_pos + 1);
+
+        if (l_size < size / 8 || r_size < size / 8) {
+            if (--bad_allowed == 0) {
+                heap_sort(begin, end, cmp);
+                return;
+            }
+            if (l_size >= INSERTION_SORT_THRESHOLD) {
+                swap(begin, begin + l_size / 4);
+                swap(pivot_pos - 1, pivot_pos - l_size / 4);
+                if (l_size > NINTHER_THRESHOLD) {
+                    swap(begin + 1, begin + (l_size / 4 + 1));
+                    swap(begin + 2, begin + (l_size / 4 + 2));
+                    swap(pivot_pos - 2, pivot_pos - (l_size / 4 + 1));
+                    swap(pivot_pos - 3, pivot_pos - (l_size / 4 + 2));
+                }
+            }
+            if (r_size >= INSERTION_SORT_THRESHOLD) {
+                swap(pivot_pos + 1, pivot_pos + (1 + r_size / 4));
+                swap(end - 1, end - r_size / 4);
+                if (r_size > NINTHER_THRESHOLD) {
+                    swap(pivot_pos + 2, pivot_pos + (2 + r_size / 4));
+                    swap(pivot_pos + 3, pivot_pos + (3 + r_size / 4));
+                    swap(end - 2, end - (1 + r_size / 4));
+                    swap(end - 3, end - (2 + r_size / 4));
+                }
+            }
+        }
+        else if (already_partitioned && partial_insertion_sort(begin, pivot_pos, cmp)
+                 && partial_insertion_sort(pivot_pos + 1, end, cmp))
+            return;
+
+        pdqsort_loop(begin, pivot_pos, cmp, bad_allowed, leftmost);
+        begin = pivot_pos + 1;
+        leftmost = false;
+    }
+}
+
+static void pdqsort(void** begin, void** end, cmp_fn cmp) {
+    size_t size = end - begin;
+    int log2_size = 0;
+    while (size >>= 1)
+        log2_size++;
+    pdqsort_loop(begin, end, cmp, log2_size, true);
+}
+
+void Vector_sort(Vector* this, int (*cmp)(const void* a, const void* b)) {
+    void** table = Vector_data(this);
+    pdqsort(table, table + Vector_size(this), cmp);
+}
+
+/* Parallel sort: every thread pdqsorts one chunk, then sorted runs are merged
+ * pairwise, one thread per pair, ping-ponging between the table and a buffer. */
+
+typedef struct SortTask {
+    void** src;
+    void** dst;
+    uint64_t begin, mid, end;
+    cmp_fn cmp;
+} SortTask;
+
+static void* sort_task(void* arg) {
+    SortTask* task = arg;
+    pdqsort(task->src + task->begin, task->src + task->end, task->cmp);
+    return NULL;
+}
+
+static void* merge_task(void* arg) {
+    SortTask* task = arg;
+    cmp_fn cmp = task->cmp;
+    void** src = task->src;
+    void** out = task->dst + task->begin;
+    uint64_t i = task->begin, j = task->mid;
+    while (i < task->mid && j < task->end)
+        *out++ = LESS(src[j], src[i]) ? src[j++] : src[i++];
+    memcpy(out, src + i, (task->mid - i) * sizeof(void*));
+    out += task->mid - i;
+    memcpy(out, src + j, (task->end - j) * sizeof(void*));
+    return NULL;
+}
+
+/* Runs func over tasks, on new threads when possible and inline otherwise */
+static void run_tasks(void* (*func)(void* ), SortTask* tasks, uint32_t count, pthread_t* threads) {
+    bool* spawned = calloc(count, sizeof(bool));
+    for (uint32_t i = 0; i < count; i++) {
+        if (spawned && i + 1 < count && pthread_create(&threads[i], NULL, func, &tasks[i]) == 0)
+            spawned[i] = true;
+        else
+            func(&tasks[i]);
+    }
+    for (uint32_t i = 0; spawned && i < count; i++)
+        if (spawned[i])
+            pthread_join(threads[i], NULL);
+    free(spawned);
+}
+
+int Vector_sort_parallel(Vector* this, int (*cmp)(const void* a, const void* b), uint32_t nthreads) {
+    uint64_t size = Vector_size(this);
+    if (nthreads > size / INSERTION_SORT_THRESHOLD)
+        nthreads = size / INSERTION_SORT_THRESHOLD;
+    if (nthreads <= 1) {
+        Vector_sort(this, cmp);
+        return 0;
+    }
+    void** table = Vector_data(this);
+    void** buffer = malloc(size * sizeof(void*));
+    uint64_t* bounds = malloc((nthreads + 1) * sizeof(uint64_t));
+    SortTask* tasks = malloc(nthreads * sizeof(SortTask));
+    pthread_t* threads = malloc(nthreads * sizeof(pthread_t));
+    if (!buffer || !bounds || !tasks || !threads) {
+        free(buffer);
+        free(bounds);
+        free(tasks);
+        free(threads);
+        return -1;
+    }
+
+    for (uint32_t i = 0; i <= nthreads; i++)
+        bounds[i] = size * i / nthreads;
+    for (uint32_t i = 0; i < nthreads; i++)
+        tasks[i] = (SortTask) { .src = table, .begin = bounds[i], .end = bounds[i + 1], .cmp = cmp };
+    run_tasks(sort_task, tasks, nthreads, threads);
+
+    void** src = table;
+    void** dst = buffer;
+    for (uint32_t runs = nthreads; runs > 1; runs = (runs + 1) / 2) {
+        uint32_t merges = 0;
+        for (uint32_t i = 0; i < runs; i += 2) {
+            /* an odd run out is "merged" with an empty run, i.e. copied */
+            uint64_t end = i + 2 <= runs ? bounds[i + 2] : bounds[i + 1];
+            tasks[merges++] = (SortTask) {
+                .src = src, .dst = dst, .cmp = cmp,
+                .begin = bounds[i], .mid = bounds[i + 1], .end = end
+            };
+        }
+        run_tasks(merge_task, tasks, merges, threads);
+        for (uint32_t i = 0; i < merges; i++)
+            bounds[i] = tasks[i].begin;
+        bounds[merges] = size;
+        void** tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+    if (src != table)
+        memcpy(table, src, size * sizeof(void*));
+
+    free(buffer);
+    free(bounds);
+    free(tasks);
+    free(threads);
+    return 0;
+}
+
+/* LSD radix sort on an integer key. Keys are extracted once, every byte that
+ * isn't the same for all items takes one stable counting pass. */
+
+typedef struct KeyedItem {
+    uint64_t key;
+    void* item;
+} KeyedItem;
+
+int Vector_radix_sort_by_key(Vector* this, uint64_t (*key)(const void* item)) {
+    uint64_t size = Vector_size(this);
+    void** table = Vector_data(this);
+    if (size < 2)
+        return 0;
+    KeyedItem* src = malloc(size * sizeof(KeyedItem));
+    KeyedItem* dst = malloc(size * sizeof(KeyedItem));
+    uint64_t (*counts)[256] = calloc(8, sizeof(*counts));
+    if (!src || !dst || !counts) {
+        free(src);
+        free(dst);
+        free(counts);
+        return -1;
+    }
+
+    for (uint64_t i = 0; i < size; i++) {
+        uint64_t k = key(table[i]);
+        src[i] = (KeyedItem) { .key = k, .item = table[i] };
+        for (int byte = 0; byte < 8; byte++)
+            counts[byte][(k >> (8 * byte)) & 0xff]++;
+    }
+
+    for (int byte = 0; byte < 8; byte++) {
+        int shift = 8 * byte;
+        if (counts[byte][(src[0].key >> shift) & 0xff] == size)
+            continue;
+        uint64_t offsets[256], offset = 0;
+        for (int digit = 0; digit < 256; digit++) {
+            offsets[digit] = offset;
+            offset += counts[byte][digit];
+        }
+        for (uint64_t i = 0; i < size; i++)
+            dst[offsets[(src[i].key >> shift) & 0xff]++] = src[i];
+        KeyedItem* tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    for (uint64_t i = 0; i < size; i++)
+        table[i] = src[i].item;
+    free(src);
+    free(dst);
+    free(counts);
+    return 0;
+}
+
+/* MSD radix sort on a string key, insertion sort for small buckets. Stable. */
+
+typedef struct StrKeyedItem {
+    const unsigned char* key;
+    void* item;
+} StrKeyedItem;
+
+static void str_insertion_sort(StrKeyedItem* items, uint64_t size, uint64_t depth) {
+    for (uint64_t i = 1; i < size; i++) {
+        StrKeyedItem tmp = items[i];
+        uint64_t j = i;
+        while (j > 0 && strcmp((const char*)items[j - 1].key + depth, (const char*)tmp.key + depth) > 0) {
+            items[j] = items[j - 1];
+            j--;
+        }
+        items[j] = tmp;
+    }
+}
+
+static void msd_radix_sort(StrKeyedItem* items, StrKeyedItem* aux, uint64_t size, uint64_t depth) {
+    while (size >= STR_INSERTION_SORT_THRESHOLD) {
+        uint64_t counts[256] = { 0 };
+        for (uint64_t i = 0; i < size; i++)
+            counts[items[i].key[depth]]++;
+        /* common prefix: go one character deeper without scattering */
+        uint8_t first = items[0].key[depth];
+        if (counts[first] == size) {
+            if (first == 0)
+                return;
+            depth++;
+            continue;
+        }
+        uint64_t offsets[256], offset = 0;
+        for (int c = 0; c < 256; c++) {
+            offsets[c] = offset;
+            offset += counts[c];
+        }
+        for (uint64_t i = 0; i < size; i++)
+            aux[offsets[items[i].key[depth]]++] = items[i];
+        memcpy(items, aux, size * sizeof(StrKeyedItem));
+        /* bucket 0 holds keys that ended, they are in place */
+        uint64_t start = counts[0];
+        for (int c = 1; c < 256; c++) {
+            if (counts[c] > 1)
+                msd_radix_sort(items + start, aux + start, counts[c], depth + 1);
+            start += counts[c];
+        }
+        return;
+    }
+    str_insertion_sort(items, size, depth);
+}
+
+int Vector_radix_sort_by_str_key(Vector* this, const char* (*key)(const void* item)) {
+    uint64_t size = Vector_size(this);
+    void** table = Vector_data(this);
+    if (size < 2)
+        return 0;
+    StrKeyedItem* items = malloc(size * sizeof(StrKeyedItem));
+    StrKeyedItem* aux = malloc(size * sizeof(StrKeyedItem));
+    if (!items || !aux) {
+        free(items);
+        free(aux);
+        return -1;
+    }
+    for (uint64_t i = 0; i < size; i++)
+        items[i] = (StrKeyedItem) { .key = (const unsigned char*)key(table[i]), .item = table[i] };
+    msd_radix_sort(items, aux, size, 0);
+    for (uint64_t i = 0; i < size; i++)
+        table[i] = items[i].item;
+    free(items);
+    free(aux);
+    return 0;
+}
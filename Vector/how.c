@@ -54,6 +54,29 @@ void part3(Vector* vec) {
     }
 }
 
+void part4(Vector* vec) {
+    Vector_set_growth_factor(vec, 1.5);
+    Vector_reserve(vec, 1000);
+    printf("vec capacity after reserve: %lu\n", Vector_capacity(vec));
+    for (int i = 0; i < 1500; i++)
+        Vector_pushback(vec, "...");
+    printf("vec size: %lu, capacity: %lu\n", Vector_size(vec), Vector_capacity(vec));
+    Vector_shrink_to_fit(vec);
+    printf("vec capacity after shrink: %lu\n", Vector_capacity(vec));
+}
+
+void part5(Vector* vec) {
+    const char* words[] = { "alpha", "beta", "gamma", "delta" };
+    Vector_clear(vec);
+    Vector_append_array(vec, (void* const*)words, 4);
+    Vector_append_vector(vec, vec);
+    Vector_erase_range(vec, 2, 3);
+    Vector_insert_range(vec, 1, (void* const*)words + 3, 1);
+    printf("swap removed: %s\n", (char*)Vector_swap_remove(vec, 0));
+    printf("popped: %s\n", (char*)Vector_pop_back(vec));
+    print_vec_str(vec);
+}
+
 int main() {
     Vector* vec = Vector_new();
     Vector_pushback(vec, "Lorem ipsum dolor");
@@ -68,6 +91,14 @@ int main() {
 
     puts("-- Part 3 ------------");
     part3(vec);
+
+    puts("-- Part 4 ------------");
+    part4(vec);
+
+    puts("-- Part 5 ------------");
+    part5(vec);
+
+    Vector_destroy(vec);
     
     return 0;
 }
\ No newline at end of file